@@ -1,6 +1,14 @@
 #pragma once
+#include "radar_algorithm/sampling.hpp"
+#include "radar_algorithm/histogram.hpp"
 #include "radar_algorithm/pulse_search.hpp"
 #include "radar_algorithm/cdif.hpp"
 #include "radar_algorithm/sdif.hpp"
 #include "radar_algorithm/pri_transform.hpp"
 #include "radar_algorithm/pulse_correlation.hpp"
+#include "radar_algorithm/thread_pool.hpp"
+#include "radar_algorithm/sweep.hpp"
+#include "radar_algorithm/emitter_chain.hpp"
+#include "radar_algorithm/shard.hpp"
+#include "radar_algorithm/track_library.hpp"
+#include "radar_algorithm/pipeline.hpp"
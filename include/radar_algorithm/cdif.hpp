@@ -1,9 +1,14 @@
 #pragma once
 #include <span>
+#include <vector>
+#include <utility>
 #include <optional>
+#include <algorithm>
+#include <type_traits>
 
 #include "radar_algorithm_ns.hpp"
 #include "radar_algorithm_export.hpp"
+#include "radar_algorithm/histogram.hpp"
 
 
 RADAR_ALGORITHM_NS_BEGIN()
@@ -18,14 +23,116 @@ public:
     /// @param data: data view
     /// @param max_rank: max stat rank
     /// @param bin_width: width of each bin
+    /// @param range: optional pri search range, limit memory to touched
+    ///     bins in range instead of whole duration
     /// @return: optional pri
     std::optional<double> run(
         std::span<double> data,
         int max_rank,
-        double bin_width
+        double bin_width,
+        std::optional<std::pair<double, double>> range = std::nullopt
     ) const noexcept;
+
+    /// @brief detect pri from prebuilt histogram, so that histogram could be
+    ///     shared by detection with different parameters
+    /// @param hist: histogram built from data
+    /// @return: optional pri
+    std::optional<double> detect(const DifferenceHistogram& hist) const noexcept;
+
+    /// state carried from lower ranks
+    struct RankState {
+        /// touched bins accumulated over checked ranks, sorted by index
+        std::vector<DifferenceHistogram::Bin> hist;
+    };
+
+    /// @brief detect pri from histogram accumulated up to `rank`, ranks
+    ///     should be checked in order from 1, so that histogram could be
+    ///     built lazily
+    /// @param hist: histogram built at least up to `rank`
+    /// @param rank: stat rank to check
+    /// @param state: state shared by checks of all ranks
+    /// @return: optional pri
+    std::optional<double> detect_rank(
+        const DifferenceHistogram& hist,
+        int rank,
+        RankState& state
+    ) const noexcept;
+    /// @brief same as `detect_rank`, with rank fixed at compile time, so that
+    ///     rank 1 copies its bins into state instead of merging
+    template<int Rank>
+    std::optional<double> detect_rank(
+        const DifferenceHistogram& hist,
+        RankState& state
+    ) const noexcept {
+        static_assert(Rank > 0, "`Rank` should be positive");
+        return _detect_rank(hist, std::integral_constant<int, Rank>(), state);
+    }
 private:
     double _k;
+
+    /// accumulate and threshold loop of single rank
+    /// @tparam RankT: `int` or `std::integral_constant<int, Rank>`
+    template<typename RankT>
+    std::optional<double> _detect_rank(
+        const DifferenceHistogram& rank_hist,
+        RankT rank,
+        RankState& state
+    ) const noexcept {
+        using Bin = DifferenceHistogram::Bin;
+        auto& hist = state.hist;
+        auto duration = rank_hist.duration();
+        auto bin_width = rank_hist.bin_width();
+        auto [first, last] = rank_hist.search_bins();
+        // stat value of bin minus threshold, untouched bin is always negative
+        auto value = [&](const Bin& bin) noexcept {
+            auto center = (bin.idx+0.5)*bin_width;
+            return bin.count - _k*duration/center;
+        };
+        auto positive = [&](size_t idx) noexcept {
+            auto it = std::lower_bound(
+                hist.begin(),
+                hist.end(),
+                idx,
+                [](const Bin& bin, size_t idx) { return bin.idx < idx; }
+            );
+            return it != hist.end() and it->idx == idx and value(*it) > 0;
+        };
+
+        // accumulate histogram of all ranks so far, nothing to merge with
+        // at rank 1
+        auto bins = rank_hist.rank(rank);
+        if (rank == 1) {
+            hist.assign(bins.begin(), bins.end());
+        } else {
+            std::vector<Bin> merged;
+            merged.reserve(hist.size()+bins.size());
+            auto it1 = hist.begin();
+            auto it2 = bins.begin();
+            while (it1 != hist.end() or it2 != bins.end()) {
+                if (it2 == bins.end() or (it1 != hist.end() and it1->idx < it2->idx)) {
+                    merged.push_back(*it1++);
+                } else if (it1 == hist.end() or it2->idx < it1->idx) {
+                    merged.push_back(*it2++);
+                } else {
+                    merged.emplace_back(it1->idx, it1->count+it2->count);
+                    it1++;
+                    it2++;
+                }
+            }
+            std::swap(hist, merged);
+        }
+
+        for (auto& bin : hist) {
+            if (bin.idx < first or bin.idx >= last) {
+                continue;
+            }
+            if (value(bin) > 0 and (positive(2*bin.idx) or positive(2*bin.idx+1))) {
+                auto pri = (bin.idx+0.5)*bin_width;
+                return std::make_optional(pri);
+            }
+        }
+        return std::nullopt;
+    }
 };
 
 RADAR_ALGORITHM_NS_END
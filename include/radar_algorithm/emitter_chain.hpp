@@ -0,0 +1,51 @@
+#pragma once
+#include <span>
+#include <optional>
+#include <functional>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm/pulse_search.hpp"
+#include "radar_algorithm/pipeline.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// estimate pri from pulses, should be safe to call concurrently
+using PRIEstimator = std::function<std::optional<double>(std::span<double>)>;
+
+/// estimator stage wrapping any pri estimator called on residue
+class PRIEstimatorStage {
+public:
+    explicit PRIEstimatorStage(PRIEstimator estimator) noexcept:
+        _estimator(std::move(estimator)) {}
+
+    /// @brief estimate pri of residue
+    std::optional<double> estimate(PipelineContext& ctx) const {
+        return _estimator(ctx.residue());
+    }
+private:
+    PRIEstimator _estimator;
+};
+
+/// chain of pri estimator and pulse searcher, pri is estimated from pulses
+/// not extracted yet and then searched, until no more emitter found
+class EmitterChain: public Pipeline<PulseSearcherStage, PRIEstimatorStage> {
+public:
+    /// @brief initialize
+    /// @param estimator: pri estimator, such as SDIF, CDIF or PRITransform
+    /// @param searcher: pulse searcher to extract pulses of estimated pri
+    /// @param max_emitter: max emitter number extracted by once run
+    EmitterChain(
+        PRIEstimator estimator,
+        PulseSearcher searcher,
+        size_t max_emitter
+    ) noexcept:
+        Pipeline(
+            PulseSearcherStage(std::move(searcher)),
+            max_emitter,
+            PRIEstimatorStage(std::move(estimator))
+        )
+    {}
+};
+
+RADAR_ALGORITHM_NS_END
@@ -0,0 +1,124 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <complex>
+#include <utility>
+#include <cstddef>
+#include <optional>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm_export.hpp"
+#include "radar_algorithm/sampling.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// toa difference histogram of each rank, shared by SDIF and CDIF,
+/// only touched bins are stored, so memory scales with pulse number
+/// rather than duration
+class RADAR_ALGORITHM_EXPORT DifferenceHistogram {
+public:
+    struct Bin {
+        /// index of bin, center of bin is `(idx+0.5)*bin_width`
+        size_t idx;
+        size_t count;
+    };
+
+    /// @brief build histogram
+    /// @param data: data view
+    /// @param max_rank: max stat rank
+    /// @param bin_width: width of each bin
+    /// @param range: optional pri search range, difference beyond twice of
+    ///     it is dropped, the rest is kept for subharmonic check
+    DifferenceHistogram(
+        std::span<double> data,
+        int max_rank,
+        double bin_width,
+        std::optional<std::pair<double, double>> range = std::nullopt
+    ) noexcept;
+
+    /// @brief pulse number of data
+    size_t pulse_num() const noexcept;
+    /// @brief duration of data
+    double duration() const noexcept;
+    /// @brief build histogram of next rank, so that detection could stop
+    ///     before higher ranks are enumerated
+    /// @param data: data view, must be the one histogram built from
+    void add_rank(std::span<double> data) noexcept;
+
+    /// @brief max stat rank built
+    int max_rank() const noexcept;
+    /// @brief width of each bin
+    double bin_width() const noexcept;
+    /// @brief number of bins to cover whole duration
+    size_t bin_num() const noexcept;
+    /// @brief index range [first, last) of bins to search pri in
+    std::pair<size_t, size_t> search_bins() const noexcept;
+    /// @brief touched bins sorted by index
+    /// @param rank: stat rank, [1, max_rank]
+    std::span<const Bin> rank(int rank) const noexcept;
+private:
+    size_t _pulse_num;
+    double _duration;
+    double _bin_width;
+    size_t _bin_num;
+    std::pair<size_t, size_t> _search_bins;
+    /// range of difference kept
+    double _lower;
+    double _upper;
+    /// touched bins of all ranks, rank by rank
+    std::vector<Bin> _bins;
+    /// start of each rank in `_bins`, with end of last rank appended
+    std::vector<size_t> _offsets;
+};
+
+
+/// complex histogram of pri transform
+class RADAR_ALGORITHM_EXPORT PhaseHistogram {
+public:
+    /// @brief build histogram
+    /// @param data: data view
+    /// @param range: pri range
+    /// @param bin_width: width of each bin
+    PhaseHistogram(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width
+    ) noexcept;
+    /// @brief estimate histogram from pairs of sampled heads, for dense data
+    ///     whose exhaustive pair enumeration is too expensive
+    /// @param data: data view
+    /// @param range: pri range
+    /// @param bin_width: width of each bin
+    /// @param sampling: how heads are sampled and candidate bins refined,
+    ///     bins of largest estimated magnitude are recomputed exactly
+    PhaseHistogram(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width,
+        const SamplingOptions& sampling
+    ) noexcept;
+
+    /// @brief pulse number of data
+    size_t pulse_num() const noexcept;
+    /// @brief duration of data
+    double duration() const noexcept;
+    /// @brief pri range
+    std::pair<double, double> range() const noexcept;
+    /// @brief width of each bin
+    double bin_width() const noexcept;
+    /// @brief stat value of each bin
+    std::span<const std::complex<double>> bins() const noexcept;
+    /// @brief confidence bound of magnitude of each bin, so that true
+    ///     magnitude lies in |bin| -/+ margin, empty if histogram is exact
+    std::span<const double> margins() const noexcept;
+private:
+    size_t _pulse_num;
+    double _duration;
+    std::pair<double, double> _range;
+    double _bin_width;
+    std::vector<std::complex<double>> _hist;
+    std::vector<double> _margins;
+};
+
+RADAR_ALGORITHM_NS_END
@@ -0,0 +1,449 @@
+#pragma once
+#include <span>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <optional>
+#include <functional>
+#include <type_traits>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm_export.hpp"
+#include "radar_algorithm/cdif.hpp"
+#include "radar_algorithm/sdif.hpp"
+#include "radar_algorithm/histogram.hpp"
+#include "radar_algorithm/pulse_search.hpp"
+#include "radar_algorithm/pri_transform.hpp"
+#include "radar_algorithm/pulse_correlation.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// emitter extracted from data
+struct Emitter {
+    /// label of extracted pulses
+    uint32_t label;
+    /// pri refined by extracted pulses
+    double pri;
+    /// toa of first and last extracted pulse
+    double first_toa;
+    double last_toa;
+    size_t pulse_num;
+};
+
+/// @brief summarize extracted pulses of emitter
+/// @param data: data view
+/// @param labels: label of each pulse
+/// @param label: label of emitter
+/// @param pri: estimated pri, used to assign period index of each pulse
+/// @return: emitter with pri refined by least squares fit
+RADAR_ALGORITHM_EXPORT Emitter make_emitter(
+    std::span<const double> data,
+    std::span<const uint32_t> labels,
+    uint32_t label,
+    double pri
+) noexcept;
+
+
+/// buffers shared by stages of pipeline, residue and histograms are built
+/// once per extraction and reused by every stage asking for them
+class RADAR_ALGORITHM_EXPORT PipelineContext {
+public:
+    /// @brief bind data to process
+    /// @param data: data view
+    /// @param labels: label of each pulse, pulse with non-zero label is
+    ///     treated as already extracted
+    /// @return: false if size of labels mismatch
+    bool bind(std::span<double> data, std::span<uint32_t> labels) noexcept;
+    /// @brief rebuild residue from labels and drop cached histograms,
+    ///     should be called after pulses extracted
+    void update_residue() noexcept;
+
+    /// @brief bound data
+    std::span<double> data() const noexcept;
+    /// @brief bound labels
+    std::span<uint32_t> labels() const noexcept;
+    /// @brief pulses not extracted yet
+    std::span<double> residue() noexcept;
+    /// @brief difference histogram of residue, shared by requests with same
+    ///     parameters, ranks are built on demand
+    /// @param rank: histogram is built at least up to `rank`
+    /// @param bin_width: width of each bin
+    /// @param range: optional pri search range
+    const DifferenceHistogram& difference_histogram(
+        int rank,
+        double bin_width,
+        std::optional<std::pair<double, double>> range
+    ) noexcept;
+    /// @brief phase histogram of residue, built on first request
+    ///     and shared by following requests with same parameters
+    const PhaseHistogram& phase_histogram(
+        std::pair<double, double> range,
+        double bin_width
+    ) noexcept;
+private:
+    std::span<double> _data;
+    std::span<uint32_t> _labels;
+    std::vector<double> _residue;
+    std::optional<DifferenceHistogram> _difference;
+    std::optional<std::pair<double, double>> _difference_range;
+    std::optional<PhaseHistogram> _phase;
+};
+
+
+/// @brief estimator stage detecting pri from difference histogram rank by
+///     rank, ranks are built only until pri detected and shared with other
+///     difference stages of same parameters
+/// @tparam Detector: SDIF or CDIF
+/// @tparam MaxRank: max stat rank, 0 if given at runtime, if fixed at compile
+///     time, rank loop is unrolled and each rank is passed to detector as
+///     compile time constant
+template<typename Detector, int MaxRank = 0>
+class DifferenceStage {
+public:
+    static_assert(MaxRank >= 0, "`MaxRank` should be non-negative");
+
+    /// @brief initialize with max rank fixed at compile time
+    /// @param detector: SDIF or CDIF
+    /// @param bin_width: width of each bin
+    /// @param range: optional pri search range
+    DifferenceStage(
+        Detector detector,
+        double bin_width,
+        std::optional<std::pair<double, double>> range = std::nullopt
+    ) noexcept requires (MaxRank > 0):
+        _detector(std::move(detector)),
+        _bin_width(bin_width),
+        _range(range)
+    {}
+    /// @brief initialize with max rank given at runtime
+    /// @param detector: SDIF or CDIF
+    /// @param max_rank: max stat rank
+    /// @param bin_width: width of each bin
+    /// @param range: optional pri search range
+    DifferenceStage(
+        Detector detector,
+        int max_rank,
+        double bin_width,
+        std::optional<std::pair<double, double>> range = std::nullopt
+    ) noexcept requires (MaxRank == 0):
+        _detector(std::move(detector)),
+        _max_rank(max_rank),
+        _bin_width(bin_width),
+        _range(range)
+    {}
+
+    /// @brief max stat rank
+    constexpr int max_rank() const noexcept {
+        return _max_rank;
+    }
+
+    /// @brief estimate pri of residue
+    std::optional<double> estimate(PipelineContext& ctx) const noexcept {
+        if (ctx.residue().size() < 2) {
+            return std::nullopt;
+        }
+        typename Detector::RankState state;
+        if constexpr (MaxRank > 0) {
+            return _estimate(ctx, state, std::make_integer_sequence<int, MaxRank>());
+        } else {
+            for (int rank = 1; rank <= _max_rank; rank++) {
+                if (auto pri = _estimate_rank(ctx, state, rank)) {
+                    return pri;
+                }
+            }
+            return std::nullopt;
+        }
+    }
+private:
+    Detector _detector;
+    /// compile time constant takes no storage
+    [[no_unique_address]] std::conditional_t<
+        (MaxRank > 0),
+        std::integral_constant<int, MaxRank>,
+        int
+    > _max_rank;
+    double _bin_width;
+    std::optional<std::pair<double, double>> _range;
+
+    std::optional<double> _estimate_rank(
+        PipelineContext& ctx,
+        typename Detector::RankState& state,
+        int rank
+    ) const noexcept {
+        auto& hist = ctx.difference_histogram(rank, _bin_width, _range);
+        return _detector.detect_rank(hist, rank, state);
+    }
+
+    template<int Rank>
+    std::optional<double> _estimate_rank(
+        PipelineContext& ctx,
+        typename Detector::RankState& state
+    ) const noexcept {
+        auto& hist = ctx.difference_histogram(Rank, _bin_width, _range);
+        return _detector.template detect_rank<Rank>(hist, state);
+    }
+
+    /// rank loop unrolled, stop at first rank detected
+    template<int... Ranks>
+    std::optional<double> _estimate(
+        PipelineContext& ctx,
+        typename Detector::RankState& state,
+        std::integer_sequence<int, Ranks...>
+    ) const noexcept {
+        std::optional<double> pri;
+        ((pri = _estimate_rank<Ranks+1>(ctx, state)).has_value() or ...);
+        return pri;
+    }
+};
+
+template<int MaxRank = 0>
+using SDIFStage = DifferenceStage<SDIF, MaxRank>;
+template<int MaxRank = 0>
+using CDIFStage = DifferenceStage<CDIF, MaxRank>;
+
+
+/// estimator stage detecting pri from phase histogram
+class PRITransformStage {
+public:
+    /// @brief initialize
+    /// @param transform: pri transform
+    /// @param range: pri range
+    /// @param bin_width: width of each bin
+    PRITransformStage(
+        PRITransform transform,
+        std::pair<double, double> range,
+        double bin_width
+    ) noexcept:
+        _transform(std::move(transform)),
+        _range(range),
+        _bin_width(bin_width)
+    {}
+
+    /// @brief estimate pri of residue
+    std::optional<double> estimate(PipelineContext& ctx) const noexcept {
+        if (ctx.residue().size() < 2) {
+            return std::nullopt;
+        }
+        return _transform.detect(ctx.phase_histogram(_range, _bin_width));
+    }
+private:
+    PRITransform _transform;
+    std::pair<double, double> _range;
+    double _bin_width;
+};
+
+
+/// extractor stage searching pulses of estimated pri
+class PulseSearcherStage {
+public:
+    explicit PulseSearcherStage(PulseSearcher searcher) noexcept:
+        _searcher(std::move(searcher)) {}
+
+    /// @brief extract pulses of `pri`
+    /// @return: number of extracted pulse
+    size_t extract(PipelineContext& ctx, double pri, uint32_t label) const noexcept {
+        return _searcher.run(pri, ctx.data(), ctx.labels(), label);
+    }
+private:
+    PulseSearcher _searcher;
+};
+
+
+/// extractor stage correlating pulse chains around estimated pri
+class PulseCorrelationStage {
+public:
+    /// @brief initialize
+    /// @param correlation: pulse correlation
+    /// @param bin_width: width of each bin
+    /// @param merge_num: how many near bins need to to be merged
+    /// @param toler: relative tolerance of pri, pri range to correlate is
+    ///     [pri*(1-toler), pri*(1+toler)]
+    PulseCorrelationStage(
+        PulseCorrelation correlation,
+        double bin_width,
+        size_t merge_num,
+        double toler
+    ) noexcept:
+        _correlation(std::move(correlation)),
+        _bin_width(bin_width),
+        _merge_num(merge_num),
+        _toler(toler)
+    {}
+
+    /// @brief extract pulses of `pri`
+    /// @return: number of extracted pulse
+    size_t extract(PipelineContext& ctx, double pri, uint32_t label) const noexcept {
+        return _correlation.run(
+            ctx.data(),
+            { pri*(1-_toler), pri*(1+_toler) },
+            _bin_width,
+            _merge_num,
+            ctx.labels(),
+            label
+        );
+    }
+private:
+    PulseCorrelation _correlation;
+    double _bin_width;
+    size_t _merge_num;
+    double _toler;
+};
+
+
+/// @brief statically typed chain of estimator stages and extractor stage,
+///     estimators are tried in order on residue until one detects pri,
+///     which is then extracted, until no more emitter found, stages are
+///     composed at compile time and share buffers of `PipelineContext`
+/// @tparam Extractor: stage with `extract(ctx, pri, label)`
+/// @tparam Estimators: stages with `estimate(ctx)`
+template<typename Extractor, typename... Estimators>
+class Pipeline {
+public:
+    static_assert(sizeof...(Estimators) > 0, "at least one estimator is required");
+
+    /// @brief initialize
+    /// @param extractor: extractor stage
+    /// @param max_emitter: max emitter number extracted by once run
+    /// @param estimators: estimator stages in order to try
+    Pipeline(Extractor extractor, size_t max_emitter, Estimators... estimators) noexcept:
+        _extractor(std::move(extractor)),
+        _max_emitter(max_emitter),
+        _estimators(std::move(estimators)...)
+    {}
+
+    /// @brief start extraction
+    /// @param data: data view
+    /// @param labels: label of each pulse, pulse with non-zero label is
+    ///     treated as already extracted and skipped
+    /// @param first_label: label of first extracted emitter, following
+    ///     emitters are labeled incrementally
+    /// @return: extracted emitters
+    std::vector<Emitter> run(
+        std::span<double> data,
+        std::span<uint32_t> labels,
+        uint32_t first_label = 1
+    ) const {
+        PipelineContext ctx;
+        return run(ctx, data, labels, first_label);
+    }
+    /// @brief start extraction with buffers of `ctx`, so that buffers could
+    ///     be reused by consecutive runs
+    std::vector<Emitter> run(
+        PipelineContext& ctx,
+        std::span<double> data,
+        std::span<uint32_t> labels,
+        uint32_t first_label = 1
+    ) const {
+        if (!ctx.bind(data, labels)) {
+            return {};
+        }
+
+        std::vector<Emitter> emitters;
+        auto label = first_label;
+        while (emitters.size() < _max_emitter) {
+            ctx.update_residue();
+            auto pri = estimate(ctx);
+            if (!pri) {
+                break;
+            }
+            // stop if estimated pri could not be extracted, or it will be
+            // estimated again
+            if (_extractor.extract(ctx, *pri, label) == 0) {
+                break;
+            }
+            emitters.push_back(make_emitter(data, labels, label, *pri));
+            label++;
+        }
+        return emitters;
+    }
+    /// @brief same as `run`, so that pipeline could be held by
+    ///     `EmitterExtractor`
+    std::vector<Emitter> operator()(
+        std::span<double> data,
+        std::span<uint32_t> labels,
+        uint32_t first_label
+    ) const {
+        return run(data, labels, first_label);
+    }
+private:
+    Extractor _extractor;
+    size_t _max_emitter;
+    std::tuple<Estimators...> _estimators;
+
+    /// try estimators in order, unrolled at compile time
+    std::optional<double> estimate(PipelineContext& ctx) const {
+        std::optional<double> pri;
+        std::apply(
+            [&](auto&... estimators) {
+                ((pri = estimators.estimate(ctx)).has_value() or ...);
+            },
+            _estimators
+        );
+        return pri;
+    }
+};
+
+
+/// estimator stages selected at runtime, such as from python,
+/// tried in order
+class AnyEstimatorStage {
+public:
+    using Stage = std::variant<SDIFStage<>, CDIFStage<>, PRITransformStage>;
+
+    explicit AnyEstimatorStage(std::vector<Stage> stages) noexcept:
+        _stages(std::move(stages)) {}
+
+    /// @brief estimate pri of residue
+    std::optional<double> estimate(PipelineContext& ctx) const noexcept {
+        for (auto& stage : _stages) {
+            auto pri = std::visit(
+                [&ctx](auto& estimator) noexcept { return estimator.estimate(ctx); },
+                stage
+            );
+            if (pri) {
+                return pri;
+            }
+        }
+        return std::nullopt;
+    }
+private:
+    std::vector<Stage> _stages;
+};
+
+
+/// extractor stage selected at runtime
+class AnyExtractorStage {
+public:
+    using Stage = std::variant<PulseSearcherStage, PulseCorrelationStage>;
+
+    explicit AnyExtractorStage(Stage stage) noexcept:
+        _stage(std::move(stage)) {}
+
+    /// @brief extract pulses of `pri`
+    /// @return: number of extracted pulse
+    size_t extract(PipelineContext& ctx, double pri, uint32_t label) const noexcept {
+        return std::visit(
+            [&](auto& extractor) noexcept { return extractor.extract(ctx, pri, label); },
+            _stage
+        );
+    }
+private:
+    Stage _stage;
+};
+
+/// pipeline whose stages are selected at runtime
+using DynamicPipeline = Pipeline<AnyExtractorStage, AnyEstimatorStage>;
+
+/// any pipeline erased of its stage types, such as `EmitterChain` or
+/// `DynamicPipeline`, called with data, labels and first label, should be
+/// safe to call concurrently
+using EmitterExtractor = std::function<std::vector<Emitter>(
+    std::span<double>,
+    std::span<uint32_t>,
+    uint32_t
+)>;
+
+RADAR_ALGORITHM_NS_END
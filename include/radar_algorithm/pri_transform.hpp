@@ -5,6 +5,7 @@
 
 #include "radar_algorithm_ns.hpp"
 #include "radar_algorithm_export.hpp"
+#include "radar_algorithm/histogram.hpp"
 
 
 RADAR_ALGORITHM_NS_BEGIN()
@@ -27,6 +28,25 @@ public:
         std::pair<double, double> range,
         double bin_width
     ) const noexcept;
+    /// @brief start pri transform algorithm on histogram estimated from
+    ///     sampled heads, trade accuracy for bounded latency on dense data
+    /// @param data: data view
+    /// @param range: pri range
+    /// @param bin_width: width of each bin
+    /// @param sampling: sampling options
+    /// @return: optional pri
+    std::optional<double> run(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width,
+        const SamplingOptions& sampling
+    ) const noexcept;
+
+    /// @brief detect pri from prebuilt histogram, so that histogram could be
+    ///     shared by detection with different parameters
+    /// @param hist: histogram built from data
+    /// @return: optional pri
+    std::optional<double> detect(const PhaseHistogram& hist) const noexcept;
 private:
     double _alpha;
     double _beta;
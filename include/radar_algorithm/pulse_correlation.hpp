@@ -1,10 +1,12 @@
 #pragma once
 #include <span>
-#include <vector>
+#include <utility>
+#include <cstdint>
 #include <optional>
 
 #include "radar_algorithm_ns.hpp"
 #include "radar_algorithm_export.hpp"
+#include "radar_algorithm/sampling.hpp"
 
 
 RADAR_ALGORITHM_NS_BEGIN()
@@ -21,16 +23,70 @@ public:
     /// @param range: pri possiable range
     /// @param bin_width: width of each bin
     /// @param merge_num: how many near bins need to to be merged
-    std::optional<std::pair<std::vector<size_t>, std::vector<size_t>>>
-    run(
+    /// @param labels: label of each pulse, pulse with non-zero label is
+    ///     treated as already extracted and skipped, extracted pulse will be
+    ///     marked as `label`
+    /// @param label: label to mark extracted pulse, should be non-zero
+    /// @return: number of extracted pulse, 0 if no pulse extracted
+    size_t run(
         std::span<double> data,
         std::pair<double, double> range,
         double bin_width,
-        size_t merge_num
+        size_t merge_num,
+        std::span<uint8_t> labels,
+        uint8_t label = 1
+    ) const noexcept;
+    size_t run(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num,
+        std::span<uint32_t> labels,
+        uint32_t label = 1
+    ) const noexcept;
+    /// @brief start pulse correlation algorithm on dense data, pair count of
+    ///     bins is estimated from sampled heads, and pair list is built only
+    ///     for `sampling.refine` bins of largest estimated count
+    /// @param data: data view
+    /// @param range: pri possiable range
+    /// @param bin_width: width of each bin
+    /// @param merge_num: how many near bins need to to be merged
+    /// @param sampling: sampling options
+    /// @param labels: label of each pulse, same as above
+    /// @param label: label to mark extracted pulse, should be non-zero
+    /// @return: number of extracted pulse, 0 if no pulse extracted
+    size_t run(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num,
+        const SamplingOptions& sampling,
+        std::span<uint8_t> labels,
+        uint8_t label = 1
+    ) const noexcept;
+    size_t run(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num,
+        const SamplingOptions& sampling,
+        std::span<uint32_t> labels,
+        uint32_t label = 1
     ) const noexcept;
 private:
     size_t _min_chain;
     size_t _thr;
+
+    template<typename Label>
+    size_t _run(
+        std::span<double> data,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num,
+        const std::optional<SamplingOptions>& sampling,
+        std::span<Label> labels,
+        Label label
+    ) const noexcept;
 };
 
 RADAR_ALGORITHM_NS_END
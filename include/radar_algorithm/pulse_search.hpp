@@ -1,8 +1,7 @@
 #pragma once
 #include <span>
-#include <vector>
 #include <cstddef>
-#include <optional>
+#include <cstdint>
 
 #include "radar_algorithm_ns.hpp"
 #include "radar_algorithm_export.hpp"
@@ -21,14 +20,70 @@ public:
     /// @brief start pri searching
     /// @param pri: specify pri to search
     /// @param data: data view
-    /// @return: searched toa and remained toa, nullopt if no pulse searched
-    std::optional<
-        std::pair<std::vector<size_t>, std::vector<size_t>>
-    > run(double pri, std::span<double> data) const noexcept;
+    /// @param labels: label of each pulse, pulse with non-zero label is
+    ///     treated as already extracted and skipped, extracted pulse will be
+    ///     marked as `label`
+    /// @param label: label to mark extracted pulse, should be non-zero
+    /// @return: number of extracted pulse, 0 if no pulse searched
+    size_t run(
+        double pri,
+        std::span<double> data,
+        std::span<uint8_t> labels,
+        uint8_t label = 1
+    ) const noexcept;
+    size_t run(
+        double pri,
+        std::span<double> data,
+        std::span<uint32_t> labels,
+        uint32_t label = 1
+    ) const noexcept;
+
+    /// @brief extract pulses of emitter whose pulse arrival is predictable,
+    ///     search starts at predicted toa `phase + k*pri` instead of every
+    ///     pulse, and continues from each found pulse
+    /// @param pri: pri of emitter
+    /// @param phase: toa of any pulse of emitter, could be out of data
+    /// @param data: data view
+    /// @param labels: label of each pulse, pulse with non-zero label is
+    ///     treated as already extracted and skipped, extracted pulse will be
+    ///     marked as `label`
+    /// @param label: label to mark extracted pulse, should be non-zero
+    /// @return: number of extracted pulse, 0 if no pulse searched
+    size_t predict(
+        double pri,
+        double phase,
+        std::span<double> data,
+        std::span<uint8_t> labels,
+        uint8_t label = 1
+    ) const noexcept;
+    size_t predict(
+        double pri,
+        double phase,
+        std::span<double> data,
+        std::span<uint32_t> labels,
+        uint32_t label = 1
+    ) const noexcept;
 private:
     size_t _thr;
     double _toler;
     double _allow_miss_rate;
+
+    template<typename Label>
+    size_t _run(
+        double pri,
+        std::span<double> data,
+        std::span<Label> labels,
+        Label label
+    ) const noexcept;
+
+    template<typename Label>
+    size_t _predict(
+        double pri,
+        double phase,
+        std::span<double> data,
+        std::span<Label> labels,
+        Label label
+    ) const noexcept;
 };
 
 RADAR_ALGORITHM_NS_END
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "radar_algorithm_ns.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// options to estimate pair histogram from a subset of pair heads
+/// instead of enumerating all pulse pairs
+struct SamplingOptions {
+    /// fraction of heads to sample, (0, 1]
+    double ratio = 0.1;
+    /// sample one head from each of equal sized strata of toa order,
+    /// otherwise sample heads uniformly
+    bool stratified = true;
+    /// seed of random generator
+    uint64_t seed = 0;
+    /// z score of confidence bound, 1.96 for 95% confidence
+    double z = 1.96;
+    /// number of candidate bins to recompute exactly, 0 to disable
+    size_t refine = 16;
+};
+
+RADAR_ALGORITHM_NS_END
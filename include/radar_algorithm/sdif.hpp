@@ -1,9 +1,13 @@
 #pragma once
 #include <span>
+#include <cmath>
+#include <utility>
 #include <optional>
+#include <type_traits>
 
 #include "radar_algorithm_ns.hpp"
 #include "radar_algorithm_export.hpp"
+#include "radar_algorithm/histogram.hpp"
 
 
 RADAR_ALGORITHM_NS_BEGIN()
@@ -18,15 +22,85 @@ public:
     /// @param data: data view
     /// @param max_rank: max stat rank
     /// @param bin_width: width of each bin
+    /// @param range: optional pri search range, limit memory to touched
+    ///     bins in range instead of whole duration
     /// @return: optional pri, need subharmonic check
     std::optional<double> run(
         std::span<double> data,
         int max_rank,
-        double bin_width
+        double bin_width,
+        std::optional<std::pair<double, double>> range = std::nullopt
     ) const noexcept;
+
+    /// @brief detect pri from prebuilt histogram, so that histogram could be
+    ///     shared by detection with different parameters
+    /// @param hist: histogram built from data
+    /// @return: optional pri, need subharmonic check
+    std::optional<double> detect(const DifferenceHistogram& hist) const noexcept;
+
+    /// state carried from lower ranks, SDIF checks each rank on its own
+    struct RankState {};
+
+    /// @brief detect pri from histogram of single rank, ranks should be
+    ///     checked in order from 1, so that histogram could be built lazily
+    /// @param hist: histogram built at least up to `rank`
+    /// @param rank: stat rank to check
+    /// @param state: state shared by checks of all ranks
+    /// @return: optional pri, need subharmonic check
+    std::optional<double> detect_rank(
+        const DifferenceHistogram& hist,
+        int rank,
+        RankState& state
+    ) const noexcept;
+    /// @brief same as `detect_rank`, with rank fixed at compile time, so that
+    ///     rank dependent branch of threshold loop is resolved when compiled
+    template<int Rank>
+    std::optional<double> detect_rank(
+        const DifferenceHistogram& hist,
+        RankState& state
+    ) const noexcept {
+        static_assert(Rank > 0, "`Rank` should be positive");
+        return _detect_rank(hist, std::integral_constant<int, Rank>(), state);
+    }
 private:
     double _x;
     double _k;
+
+    /// threshold loop of single rank
+    /// @tparam RankT: `int` or `std::integral_constant<int, Rank>`
+    template<typename RankT>
+    std::optional<double> _detect_rank(
+        const DifferenceHistogram& hist,
+        RankT rank,
+        RankState&
+    ) const noexcept {
+        auto bin_width = hist.bin_width();
+        auto bin_num = hist.bin_num();
+        auto [first, last] = hist.search_bins();
+        auto scale = _x*(hist.pulse_num()-rank);
+
+        // threshold is positive, so untouched bins never exceed it
+        std::optional<double> detected;
+        for (auto [i, count] : hist.rank(rank)) {
+            if (i < first or i >= last) {
+                continue;
+            }
+            auto pri = (i+0.5)*bin_width;
+            if (count <= scale*std::exp(-pri/_k/bin_num)) {
+                continue;
+            }
+            // first peak is detected, except that peak of rank 1 should be
+            // unique
+            if (rank != 1) {
+                return std::make_optional(pri);
+            }
+            if (detected) {
+                return std::nullopt;
+            }
+            detected = pri;
+        }
+        return detected;
+    }
 };
 
 RADAR_ALGORITHM_NS_END
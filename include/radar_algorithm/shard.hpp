@@ -0,0 +1,69 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm_export.hpp"
+#include "radar_algorithm/thread_pool.hpp"
+#include "radar_algorithm/pipeline.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// emitter track stitched across windows
+struct Track {
+    /// label of pulses belong to track
+    uint32_t label;
+    /// pri averaged over windows weighted by pulse number
+    double pri;
+    /// toa of first and last pulse
+    double first_toa;
+    double last_toa;
+    size_t pulse_num;
+};
+
+/// split long capture into overlapped windows, run emitter pipeline on each
+/// window in parallel, then stitch emitters of windows into tracks
+class RADAR_ALGORITHM_EXPORT ShardedProcessor {
+public:
+    /// @brief initialize
+    /// @param pool: thread pool to process windows on
+    /// @param chain: emitter pipeline run on each window, such as
+    ///     `EmitterChain` or `DynamicPipeline`
+    /// @param window: duration of each window
+    /// @param overlap: duration shared by adjacent windows, less than `window`
+    /// @param pri_toler: relative tolerance to match pri across windows
+    /// @param phase_toler: toa tolerance to match phase across windows
+    /// @param max_gap: number of consecutive windows a track could be missed
+    ///     by and still be continued
+    ShardedProcessor(
+        ThreadPool& pool,
+        EmitterExtractor chain,
+        double window,
+        double overlap,
+        double pri_toler,
+        double phase_toler,
+        size_t max_gap = 0
+    ) noexcept;
+
+    /// @brief start processing
+    /// @param data: data view
+    /// @param labels: label of each pulse to fill, 0 for pulse belong to no
+    ///     track, pulse of track `i` labeled `i+1`
+    /// @return: stitched tracks
+    std::vector<Track> run(
+        std::span<double> data,
+        std::span<uint32_t> labels
+    ) const;
+private:
+    ThreadPool& _pool;
+    EmitterExtractor _chain;
+    double _window;
+    double _overlap;
+    double _pri_toler;
+    double _phase_toler;
+    size_t _max_gap;
+};
+
+RADAR_ALGORITHM_NS_END
@@ -0,0 +1,124 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm_export.hpp"
+#include "radar_algorithm/thread_pool.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// toa data with ground truth
+struct LabeledDataset {
+    /// sorted toa of pulses
+    std::span<double> toas;
+    /// emitter label of each pulse, 0 for noise, emitter `i` labeled `i+1`
+    std::span<const uint32_t> labels;
+    /// pri of each emitter
+    std::span<const double> pris;
+};
+
+/// evaluation result of one parameter combination
+struct SweepRecord {
+    /// parameter values, in order of grid arguments of sweep method
+    std::vector<double> params;
+    /// accuracy averaged over datasets, [0, 1]
+    double accuracy;
+    /// runtime in seconds averaged over datasets
+    double runtime;
+};
+
+class RADAR_ALGORITHM_EXPORT ParameterSweeper {
+public:
+    /// @brief initialize
+    /// @param pool: thread pool to evaluate parameter combinations on
+    /// @param pri_toler: relative tolerance to treat detected pri as correct
+    ParameterSweeper(ThreadPool& pool, double pri_toler) noexcept;
+
+    /// @brief sweep parameters of SDIF, histogram of each dataset is shared
+    ///     by all parameter combinations, accuracy is rate of dataset whose
+    ///     detected pri matches one of emitters
+    /// @param datasets: labeled datasets
+    /// @param xs, ks: grid of `x` and `k`
+    /// @param max_rank: max stat rank
+    /// @param bin_width: width of each bin
+    /// @return: record of each combination, params are (x, k)
+    std::vector<SweepRecord> sweep_sdif(
+        std::span<const LabeledDataset> datasets,
+        std::span<const double> xs,
+        std::span<const double> ks,
+        int max_rank,
+        double bin_width
+    ) const;
+
+    /// @brief sweep parameters of CDIF, histogram is shared as SDIF does
+    /// @param datasets: labeled datasets
+    /// @param ks: grid of `k`
+    /// @param max_rank: max stat rank
+    /// @param bin_width: width of each bin
+    /// @return: record of each combination, params are (k)
+    std::vector<SweepRecord> sweep_cdif(
+        std::span<const LabeledDataset> datasets,
+        std::span<const double> ks,
+        int max_rank,
+        double bin_width
+    ) const;
+
+    /// @brief sweep parameters of PRITransform, histogram is shared as
+    ///     SDIF does
+    /// @param datasets: labeled datasets
+    /// @param alphas, betas, gammas: grid of `alpha`, `beta` and `gamma`
+    /// @param range: pri range
+    /// @param bin_width: width of each bin
+    /// @return: record of each combination, params are (alpha, beta, gamma)
+    std::vector<SweepRecord> sweep_pri_transform(
+        std::span<const LabeledDataset> datasets,
+        std::span<const double> alphas,
+        std::span<const double> betas,
+        std::span<const double> gammas,
+        std::pair<double, double> range,
+        double bin_width
+    ) const;
+
+    /// @brief sweep parameters of PulseSearcher, pri of each emitter is
+    ///     searched in turn, accuracy is rate of correctly labeled pulse,
+    ///     extracted labels are matched to emitters one to one
+    /// @param datasets: labeled datasets
+    /// @param thrs, tolers, allow_miss_rates: grid of `thr`, `toler` and
+    ///     `allow_miss_rate`
+    /// @return: record of each combination, params are
+    ///     (thr, toler, allow_miss_rate)
+    std::vector<SweepRecord> sweep_pulse_searcher(
+        std::span<const LabeledDataset> datasets,
+        std::span<const size_t> thrs,
+        std::span<const double> tolers,
+        std::span<const double> allow_miss_rates
+    ) const;
+
+    /// @brief sweep parameters of PulseCorrelation, extraction is repeated
+    ///     until nothing extracted, accuracy is rate of correctly labeled pulse,
+    ///     extracted labels are matched to emitters one to one, so that
+    ///     fragmented emitter is penalized
+    /// @param datasets: labeled datasets
+    /// @param min_chains, thrs: grid of `min_chain` and `thr`
+    /// @param range: pri range
+    /// @param bin_width: width of each bin
+    /// @param merge_num: how many near bins need to to be merged
+    /// @return: record of each combination, params are (min_chain, thr)
+    std::vector<SweepRecord> sweep_pulse_correlation(
+        std::span<const LabeledDataset> datasets,
+        std::span<const size_t> min_chains,
+        std::span<const size_t> thrs,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num
+    ) const;
+private:
+    ThreadPool& _pool;
+    double _pri_toler;
+};
+
+RADAR_ALGORITHM_NS_END
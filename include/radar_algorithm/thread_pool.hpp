@@ -0,0 +1,122 @@
+#pragma once
+#include <mutex>
+#include <queue>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm_export.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+class RADAR_ALGORITHM_EXPORT ThreadPool {
+public:
+    /// @brief initialize
+    /// @param thread_num: number of worker thread, 0 means hardware concurrency
+    explicit ThreadPool(size_t thread_num = 0) noexcept;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool() noexcept;
+
+    /// @brief number of worker thread
+    size_t size() const noexcept;
+
+    /// @brief submit task to thread pool, task will be run in calling thread
+    ///     if pool already shutdown
+    /// @param func: task to run
+    /// @return: future of task result
+    template<typename Func>
+    std::future<std::invoke_result_t<Func>> submit(Func&& func) {
+        using Result = std::invoke_result_t<Func>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Func>(func)
+        );
+        auto future = task->get_future();
+        _push([task]() { (*task)(); });
+        return future;
+    }
+
+    /// @brief call `func(i)` for i in [0, n) in parallel, return after all done,
+    ///     calling thread also takes part in and only waits helpers already
+    ///     started, helper starting after loop exhausted returns at once,
+    ///     so it is safe to call inside task
+    /// @param n: loop count
+    /// @param func: loop body
+    template<typename Func>
+    void parallel_for(size_t n, Func&& func) {
+        // helper may be run after return, so state is shared,
+        // and `func` is touched only by helper started before exhausted
+        struct State {
+            std::atomic<size_t> next = 0;
+            size_t n;
+            size_t active = 0;
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<State>();
+        state->n = n;
+        auto body = &func;
+        auto work = [](State& state, auto& func) {
+            try {
+                for (auto i = state.next++; i < state.n; i = state.next++) {
+                    func(i);
+                }
+            } catch (...) {
+                std::lock_guard lock(state.mutex);
+                if (!state.error) {
+                    state.error = std::current_exception();
+                }
+            }
+        };
+
+        auto helper_num = std::min(size(), n) - (n > 0);
+        for (size_t i = 0; i < helper_num; i++) {
+            _push([state, body, work]() {
+                {
+                    std::lock_guard lock(state->mutex);
+                    if (state->next >= state->n) {
+                        return;
+                    }
+                    state->active++;
+                }
+                work(*state, *body);
+                {
+                    std::lock_guard lock(state->mutex);
+                    state->active--;
+                }
+                state->cond.notify_all();
+            });
+        }
+        work(*state, func);
+
+        // loop is exhausted, so no more helper could become active
+        std::unique_lock lock(state->mutex);
+        state->cond.wait(lock, [&state]() { return state->active == 0; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    /// @brief stop accepting task, wait all submitted task done
+    void shutdown() noexcept;
+private:
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _stopped;
+
+    void _push(std::function<void()> task);
+};
+
+RADAR_ALGORITHM_NS_END
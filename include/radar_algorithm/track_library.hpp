@@ -0,0 +1,75 @@
+#pragma once
+#include <span>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+#include "radar_algorithm_ns.hpp"
+#include "radar_algorithm_export.hpp"
+#include "radar_algorithm/pipeline.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// emitter known from previous windows
+struct KnownEmitter {
+    /// unique id, used as label of its pulses
+    uint32_t id;
+    double pri;
+    /// toa of last pulse, predicted pulses arrive at `phase + k*pri`
+    double phase;
+    /// search tolerance around predicted toa
+    double toler;
+    /// number of windows since last seen
+    size_t age;
+};
+
+/// persistent library of known emitters over consecutive windows, pulses of
+/// known emitters are extracted by prediction before running emitter pipeline,
+/// so expensive histogram estimators only see residual pulses, library is
+/// safe to share between threads, access to it is serialized
+class RADAR_ALGORITHM_EXPORT TrackLibrary {
+public:
+    /// @brief initialize
+    /// @param chain: emitter pipeline to discover new emitters from residue,
+    ///     such as `EmitterChain` or `DynamicPipeline`
+    /// @param thr: extract known emitter only when pulse number exceed `thr`
+    /// @param toler: search tolerance of new emitter
+    /// @param allow_miss_rate: the miss rate could be allowed in prediction
+    /// @param max_age: emitter not seen for more than `max_age` windows is
+    ///     dropped
+    TrackLibrary(
+        EmitterExtractor chain,
+        size_t thr,
+        double toler,
+        double allow_miss_rate,
+        size_t max_age
+    ) noexcept;
+
+    /// @brief process next window, windows should be fed in time order
+    /// @param data: data view of window
+    /// @param labels: label of each pulse to fill, pulses of emitter are
+    ///     labeled by its id, 0 for unextracted
+    /// @return: emitters found in window, labeled by their id
+    std::vector<Emitter> process(
+        std::span<double> data,
+        std::span<uint32_t> labels
+    );
+
+    /// @brief snapshot of known emitters
+    std::vector<KnownEmitter> emitters() const;
+
+    /// @brief forget all known emitters
+    void clear() noexcept;
+private:
+    EmitterExtractor _chain;
+    size_t _thr;
+    double _toler;
+    double _allow_miss_rate;
+    size_t _max_age;
+    uint32_t _next_id;
+    std::vector<KnownEmitter> _emitters;
+    mutable std::mutex _mutex;
+};
+
+RADAR_ALGORITHM_NS_END
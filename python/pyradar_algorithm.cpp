@@ -1,6 +1,13 @@
+#include <span>
+#include <vector>
+#include <cstdint>
+
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
 #include <nanobind/stl/pair.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/vector.h>
+#include <nanobind/stl/variant.h>
 #include <nanobind/stl/optional.h>
 #include <spdlog/spdlog.h>
 
@@ -8,7 +15,14 @@
 #include "radar_algorithm.hpp"
 namespace nb = nanobind;
 using Float64NumpyArray = nb::ndarray<nb::numpy, double, nb::ndim<1>, nb::c_contig>;
-using SizeTNumpyArray = nb::ndarray<nb::numpy, size_t, nb::ndim<1>, nb::c_contig>;
+template<typename Label>
+using LabelNumpyArray = nb::ndarray<nb::numpy, Label, nb::ndim<1>, nb::c_contig>;
+/// toas, emitter label of each pulse and pri of each emitter
+using PyLabeledDataset = std::tuple<
+    Float64NumpyArray,
+    LabelNumpyArray<const uint32_t>,
+    nb::ndarray<nb::numpy, const double, nb::ndim<1>, nb::c_contig>
+>;
 
 
 template<typename T>
@@ -25,23 +39,194 @@ nb::ndarray<nb::numpy, T, nb::ndim<1>, nb::c_contig> vec2numpy(std::vector<T>&&
 }
 
 
+/// shared native thread pool running async tasks
+static RADAR_ALGORITHM_NS::ThreadPool& thread_pool() noexcept {
+    static RADAR_ALGORITHM_NS::ThreadPool pool;
+    return pool;
+}
+
+
+/// @brief run `native` on thread pool without gil, then convert its result
+///     to python object by `finish` with gil held
+/// @param native: callable run without gil, should only capture native data
+/// @param finish: callable convert result, python objects which should be
+///     kept alive until task done are captured by it
+/// @return: `concurrent.futures.Future` object
+template<typename Native, typename Finish>
+nb::object submit_async(Native&& native, Finish&& finish) {
+    auto future = nb::module_::import_("concurrent.futures").attr("Future")();
+    // reference of future is released by task with gil held
+    auto future_ptr = future.inc_ref().ptr();
+    thread_pool().submit(
+        [
+            future_ptr,
+            native = std::forward<Native>(native),
+            finish = std::forward<Finish>(finish)
+        ]() mutable noexcept {
+            nb::handle future(future_ptr);
+            {
+                nb::gil_scoped_acquire acquire;
+                bool cancelled = true;
+                try {
+                    cancelled = !nb::cast<bool>(
+                        future.attr("set_running_or_notify_cancel")()
+                    );
+                } catch (nb::python_error& e) {
+                    e.discard_as_unraisable(__func__);
+                }
+                if (cancelled) {
+                    // release captured python objects with gil held
+                    [[maybe_unused]] auto _finish = std::move(finish);
+                    future.dec_ref();
+                    return;
+                }
+            }
+
+            auto res = native();
+
+            nb::gil_scoped_acquire acquire;
+            auto _finish = std::move(finish);
+            try {
+                future.attr("set_result")(_finish(std::move(res)));
+            } catch (nb::python_error& e) {
+                e.discard_as_unraisable(__func__);
+            }
+            future.dec_ref();
+        }
+    );
+    return future;
+}
+
+
+class PyDifferenceHistogram: public RADAR_ALGORITHM_NS::DifferenceHistogram {
+public:
+    PyDifferenceHistogram(
+        Float64NumpyArray toas,
+        int max_rank,
+        double bin_width,
+        std::optional<std::pair<double, double>> range
+    ) noexcept:
+        RADAR_ALGORITHM_NS::DifferenceHistogram(
+            { toas.data(), toas.size() },
+            max_rank,
+            bin_width,
+            range
+        ) {}
+};
+
+
+class PyPhaseHistogram: public RADAR_ALGORITHM_NS::PhaseHistogram {
+public:
+    PyPhaseHistogram(
+        Float64NumpyArray toas,
+        std::pair<double, double> range,
+        double bin_width
+    ) noexcept:
+        RADAR_ALGORITHM_NS::PhaseHistogram(
+            { toas.data(), toas.size() },
+            range,
+            bin_width
+        ) {}
+    PyPhaseHistogram(
+        Float64NumpyArray toas,
+        std::pair<double, double> range,
+        double bin_width,
+        const RADAR_ALGORITHM_NS::SamplingOptions& sampling
+    ) noexcept:
+        RADAR_ALGORITHM_NS::PhaseHistogram(
+            { toas.data(), toas.size() },
+            range,
+            bin_width,
+            sampling
+        ) {}
+};
+
+
 class PyPulseSearcher: public RADAR_ALGORITHM_NS::PulseSearcher {
 public:
     PyPulseSearcher(size_t thr, double toler, double allow_miss_rate) noexcept:
         RADAR_ALGORITHM_NS::PulseSearcher(thr, toler, allow_miss_rate) {}
 
-    std::optional<
-        std::pair<SizeTNumpyArray, SizeTNumpyArray>
-    > run_from_py(double pri, const nb::ndarray<double, nb::ndim<1>>& toas) const noexcept {
-        auto res = run(pri, { toas.data(), toas.size() });
-        if (!res) {
+    template<typename Label>
+    std::optional<LabelNumpyArray<Label>> run_from_py(
+        double pri,
+        Float64NumpyArray toas,
+        std::optional<LabelNumpyArray<Label>> labels,
+        Label label
+    ) const noexcept {
+        if (!labels) {
+            labels = vec2numpy(std::vector<Label>(toas.size(), 0));
+        }
+        size_t count;
+        {
+            nb::gil_scoped_release release;
+            count = run(
+                pri,
+                { toas.data(), toas.size() },
+                { labels->data(), labels->size() },
+                label
+            );
+        }
+        if (count == 0) {
             return std::nullopt;
         }
-        return std::make_optional(
-            std::make_pair(
-                vec2numpy(std::move(res->first)),
-                vec2numpy(std::move(res->second))
-            )
+        return labels;
+    }
+
+    template<typename Label>
+    std::optional<LabelNumpyArray<Label>> predict_from_py(
+        double pri,
+        double phase,
+        Float64NumpyArray toas,
+        std::optional<LabelNumpyArray<Label>> labels,
+        Label label
+    ) const noexcept {
+        if (!labels) {
+            labels = vec2numpy(std::vector<Label>(toas.size(), 0));
+        }
+        size_t count;
+        {
+            nb::gil_scoped_release release;
+            count = predict(
+                pri,
+                phase,
+                { toas.data(), toas.size() },
+                { labels->data(), labels->size() },
+                label
+            );
+        }
+        if (count == 0) {
+            return std::nullopt;
+        }
+        return labels;
+    }
+
+    template<typename Label>
+    nb::object run_async_from_py(
+        double pri,
+        Float64NumpyArray toas,
+        std::optional<LabelNumpyArray<Label>> labels,
+        Label label
+    ) const {
+        if (!labels) {
+            labels = vec2numpy(std::vector<Label>(toas.size(), 0));
+        }
+        return submit_async(
+            [
+                searcher = RADAR_ALGORITHM_NS::PulseSearcher(*this),
+                pri,
+                data = std::span<double>(toas.data(), toas.size()),
+                label_view = std::span<Label>(labels->data(), labels->size()),
+                label
+            ]() noexcept {
+                return searcher.run(pri, data, label_view, label);
+            },
+            [toas, labels = *labels](size_t count) -> nb::object {
+                if (count == 0) {
+                    return nb::none();
+                }
+                return nb::cast(labels);
+            }
         );
     }
 };
@@ -55,9 +240,36 @@ public:
     std::optional<double> run_from_py(
         Float64NumpyArray toas,
         int max_rank,
-        double bin_width
+        double bin_width,
+        std::optional<std::pair<double, double>> range
     ) const noexcept {
-        return run({ toas.data(), toas.size() }, max_rank, bin_width);
+        nb::gil_scoped_release release;
+        return run({ toas.data(), toas.size() }, max_rank, bin_width, range);
+    }
+
+    std::optional<double> detect_from_py(const PyDifferenceHistogram& hist) const noexcept {
+        nb::gil_scoped_release release;
+        return detect(hist);
+    }
+
+    nb::object run_async_from_py(
+        Float64NumpyArray toas,
+        int max_rank,
+        double bin_width,
+        std::optional<std::pair<double, double>> range
+    ) const {
+        return submit_async(
+            [
+                cdif = RADAR_ALGORITHM_NS::CDIF(*this),
+                data = std::span<double>(toas.data(), toas.size()),
+                max_rank,
+                bin_width,
+                range
+            ]() noexcept {
+                return cdif.run(data, max_rank, bin_width, range);
+            },
+            [toas](std::optional<double> pri) { return nb::cast(pri); }
+        );
     }
 };
 
@@ -70,9 +282,36 @@ public:
     std::optional<double> run_from_py(
         Float64NumpyArray toas,
         int max_rank,
-        double bin_width
+        double bin_width,
+        std::optional<std::pair<double, double>> range
     ) const noexcept {
-        return run({ toas.data(), toas.size() }, max_rank, bin_width);
+        nb::gil_scoped_release release;
+        return run({ toas.data(), toas.size() }, max_rank, bin_width, range);
+    }
+
+    std::optional<double> detect_from_py(const PyDifferenceHistogram& hist) const noexcept {
+        nb::gil_scoped_release release;
+        return detect(hist);
+    }
+
+    nb::object run_async_from_py(
+        Float64NumpyArray toas,
+        int max_rank,
+        double bin_width,
+        std::optional<std::pair<double, double>> range
+    ) const {
+        return submit_async(
+            [
+                sdif = RADAR_ALGORITHM_NS::SDIF(*this),
+                data = std::span<double>(toas.data(), toas.size()),
+                max_rank,
+                bin_width,
+                range
+            ]() noexcept {
+                return sdif.run(data, max_rank, bin_width, range);
+            },
+            [toas](std::optional<double> pri) { return nb::cast(pri); }
+        );
     }
 };
 
@@ -85,10 +324,43 @@ public:
     std::optional<double> run_from_py(
         Float64NumpyArray toas,
         std::pair<double, double> range,
-        double bin_width
+        double bin_width,
+        std::optional<RADAR_ALGORITHM_NS::SamplingOptions> sampling
     ) const noexcept {
+        nb::gil_scoped_release release;
+        if (sampling) {
+            return run({ toas.data(), toas.size() }, range, bin_width, *sampling);
+        }
         return run({ toas.data(), toas.size() }, range, bin_width);
     }
+
+    std::optional<double> detect_from_py(const PyPhaseHistogram& hist) const noexcept {
+        nb::gil_scoped_release release;
+        return detect(hist);
+    }
+
+    nb::object run_async_from_py(
+        Float64NumpyArray toas,
+        std::pair<double, double> range,
+        double bin_width,
+        std::optional<RADAR_ALGORITHM_NS::SamplingOptions> sampling
+    ) const {
+        return submit_async(
+            [
+                transform = RADAR_ALGORITHM_NS::PRITransform(*this),
+                data = std::span<double>(toas.data(), toas.size()),
+                range,
+                bin_width,
+                sampling
+            ]() noexcept {
+                if (sampling) {
+                    return transform.run(data, range, bin_width, *sampling);
+                }
+                return transform.run(data, range, bin_width);
+            },
+            [toas](std::optional<double> pri) { return nb::cast(pri); }
+        );
+    }
 };
 
 
@@ -97,23 +369,373 @@ public:
     PyPulseCorrelation(size_t min_chain, size_t thr) noexcept:
         RADAR_ALGORITHM_NS::PulseCorrelation(min_chain, thr) {}
 
-    std::optional<
-        std::pair<SizeTNumpyArray, SizeTNumpyArray>
-    > run_from_py(Float64NumpyArray toas, std::pair<double, double> range, double bin_width, size_t merge_num) const noexcept {
-        auto res = run({ toas.data(), toas.size() }, range, bin_width, merge_num);
-        if (!res) {
+    template<typename Label>
+    std::optional<LabelNumpyArray<Label>> run_from_py(
+        Float64NumpyArray toas,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num,
+        std::optional<LabelNumpyArray<Label>> labels,
+        Label label,
+        std::optional<RADAR_ALGORITHM_NS::SamplingOptions> sampling
+    ) const noexcept {
+        if (!labels) {
+            labels = vec2numpy(std::vector<Label>(toas.size(), 0));
+        }
+        size_t count;
+        {
+            nb::gil_scoped_release release;
+            std::span<double> data(toas.data(), toas.size());
+            std::span<Label> label_view(labels->data(), labels->size());
+            count = sampling
+                ? run(data, range, bin_width, merge_num, *sampling, label_view, label)
+                : run(data, range, bin_width, merge_num, label_view, label);
+        }
+        if (count == 0) {
             return std::nullopt;
         }
-        return std::make_optional(
-            std::make_pair(
-                vec2numpy(std::move(res->first)),
-                vec2numpy(std::move(res->second))
-            )
+        return labels;
+    }
+
+    template<typename Label>
+    nb::object run_async_from_py(
+        Float64NumpyArray toas,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num,
+        std::optional<LabelNumpyArray<Label>> labels,
+        Label label,
+        std::optional<RADAR_ALGORITHM_NS::SamplingOptions> sampling
+    ) const {
+        if (!labels) {
+            labels = vec2numpy(std::vector<Label>(toas.size(), 0));
+        }
+        return submit_async(
+            [
+                correlation = RADAR_ALGORITHM_NS::PulseCorrelation(*this),
+                data = std::span<double>(toas.data(), toas.size()),
+                range,
+                bin_width,
+                merge_num,
+                label_view = std::span<Label>(labels->data(), labels->size()),
+                label,
+                sampling
+            ]() noexcept {
+                if (sampling) {
+                    return correlation.run(
+                        data,
+                        range,
+                        bin_width,
+                        merge_num,
+                        *sampling,
+                        label_view,
+                        label
+                    );
+                }
+                return correlation.run(
+                    data,
+                    range,
+                    bin_width,
+                    merge_num,
+                    label_view,
+                    label
+                );
+            },
+            [toas, labels = *labels](size_t count) -> nb::object {
+                if (count == 0) {
+                    return nb::none();
+                }
+                return nb::cast(labels);
+            }
         );
     }
 };
 
 
+class PyParameterSweeper: public RADAR_ALGORITHM_NS::ParameterSweeper {
+public:
+    PyParameterSweeper(double pri_toler) noexcept:
+        RADAR_ALGORITHM_NS::ParameterSweeper(thread_pool(), pri_toler) {}
+
+    std::vector<RADAR_ALGORITHM_NS::SweepRecord> sweep_sdif_from_py(
+        const std::vector<PyLabeledDataset>& datasets,
+        const std::vector<double>& xs,
+        const std::vector<double>& ks,
+        int max_rank,
+        double bin_width
+    ) const {
+        auto views = to_views(datasets);
+        nb::gil_scoped_release release;
+        return sweep_sdif(views, xs, ks, max_rank, bin_width);
+    }
+
+    std::vector<RADAR_ALGORITHM_NS::SweepRecord> sweep_cdif_from_py(
+        const std::vector<PyLabeledDataset>& datasets,
+        const std::vector<double>& ks,
+        int max_rank,
+        double bin_width
+    ) const {
+        auto views = to_views(datasets);
+        nb::gil_scoped_release release;
+        return sweep_cdif(views, ks, max_rank, bin_width);
+    }
+
+    std::vector<RADAR_ALGORITHM_NS::SweepRecord> sweep_pri_transform_from_py(
+        const std::vector<PyLabeledDataset>& datasets,
+        const std::vector<double>& alphas,
+        const std::vector<double>& betas,
+        const std::vector<double>& gammas,
+        std::pair<double, double> range,
+        double bin_width
+    ) const {
+        auto views = to_views(datasets);
+        nb::gil_scoped_release release;
+        return sweep_pri_transform(views, alphas, betas, gammas, range, bin_width);
+    }
+
+    std::vector<RADAR_ALGORITHM_NS::SweepRecord> sweep_pulse_searcher_from_py(
+        const std::vector<PyLabeledDataset>& datasets,
+        const std::vector<size_t>& thrs,
+        const std::vector<double>& tolers,
+        const std::vector<double>& allow_miss_rates
+    ) const {
+        auto views = to_views(datasets);
+        nb::gil_scoped_release release;
+        return sweep_pulse_searcher(views, thrs, tolers, allow_miss_rates);
+    }
+
+    std::vector<RADAR_ALGORITHM_NS::SweepRecord> sweep_pulse_correlation_from_py(
+        const std::vector<PyLabeledDataset>& datasets,
+        const std::vector<size_t>& min_chains,
+        const std::vector<size_t>& thrs,
+        std::pair<double, double> range,
+        double bin_width,
+        size_t merge_num
+    ) const {
+        auto views = to_views(datasets);
+        nb::gil_scoped_release release;
+        return sweep_pulse_correlation(
+            views,
+            min_chains,
+            thrs,
+            range,
+            bin_width,
+            merge_num
+        );
+    }
+private:
+    static std::vector<RADAR_ALGORITHM_NS::LabeledDataset> to_views(
+        const std::vector<PyLabeledDataset>& datasets
+    ) {
+        std::vector<RADAR_ALGORITHM_NS::LabeledDataset> views;
+        views.reserve(datasets.size());
+        for (auto& [toas, labels, pris] : datasets) {
+            views.emplace_back(
+                std::span<double>(toas.data(), toas.size()),
+                std::span<const uint32_t>(labels.data(), labels.size()),
+                std::span<const double>(pris.data(), pris.size())
+            );
+        }
+        return views;
+    }
+};
+
+
+class PyEmitterChain: public RADAR_ALGORITHM_NS::EmitterChain {
+public:
+    using RADAR_ALGORITHM_NS::EmitterChain::EmitterChain;
+
+    static PyEmitterChain from_sdif(
+        const PySDIF& sdif,
+        int max_rank,
+        double bin_width,
+        const PyPulseSearcher& searcher,
+        size_t max_emitter,
+        std::optional<std::pair<double, double>> range
+    ) noexcept {
+        return PyEmitterChain(
+            [
+                sdif = RADAR_ALGORITHM_NS::SDIF(sdif),
+                max_rank,
+                bin_width,
+                range
+            ](std::span<double> data) noexcept {
+                return sdif.run(data, max_rank, bin_width, range);
+            },
+            searcher,
+            max_emitter
+        );
+    }
+
+    static PyEmitterChain from_cdif(
+        const PyCDIF& cdif,
+        int max_rank,
+        double bin_width,
+        const PyPulseSearcher& searcher,
+        size_t max_emitter,
+        std::optional<std::pair<double, double>> range
+    ) noexcept {
+        return PyEmitterChain(
+            [
+                cdif = RADAR_ALGORITHM_NS::CDIF(cdif),
+                max_rank,
+                bin_width,
+                range
+            ](std::span<double> data) noexcept {
+                return cdif.run(data, max_rank, bin_width, range);
+            },
+            searcher,
+            max_emitter
+        );
+    }
+
+    static PyEmitterChain from_pri_transform(
+        const PyPRITransform& transform,
+        std::pair<double, double> range,
+        double bin_width,
+        const PyPulseSearcher& searcher,
+        size_t max_emitter
+    ) noexcept {
+        return PyEmitterChain(
+            [
+                transform = RADAR_ALGORITHM_NS::PRITransform(transform),
+                range,
+                bin_width
+            ](std::span<double> data) noexcept {
+                return transform.run(data, range, bin_width);
+            },
+            searcher,
+            max_emitter
+        );
+    }
+
+    std::pair<LabelNumpyArray<uint32_t>, std::vector<RADAR_ALGORITHM_NS::Emitter>>
+    run_from_py(
+        Float64NumpyArray toas,
+        std::optional<LabelNumpyArray<uint32_t>> labels,
+        uint32_t first_label
+    ) const {
+        if (!labels) {
+            labels = vec2numpy(std::vector<uint32_t>(toas.size(), 0));
+        }
+        std::vector<RADAR_ALGORITHM_NS::Emitter> emitters;
+        {
+            nb::gil_scoped_release release;
+            emitters = run(
+                { toas.data(), toas.size() },
+                { labels->data(), labels->size() },
+                first_label
+            );
+        }
+        return std::make_pair(*labels, std::move(emitters));
+    }
+};
+
+
+class PyPipeline: public RADAR_ALGORITHM_NS::DynamicPipeline {
+public:
+    PyPipeline(
+        std::vector<RADAR_ALGORITHM_NS::AnyEstimatorStage::Stage> estimators,
+        RADAR_ALGORITHM_NS::AnyExtractorStage::Stage extractor,
+        size_t max_emitter
+    ) noexcept:
+        RADAR_ALGORITHM_NS::DynamicPipeline(
+            RADAR_ALGORITHM_NS::AnyExtractorStage(std::move(extractor)),
+            max_emitter,
+            RADAR_ALGORITHM_NS::AnyEstimatorStage(std::move(estimators))
+        ) {}
+
+    std::pair<LabelNumpyArray<uint32_t>, std::vector<RADAR_ALGORITHM_NS::Emitter>>
+    run_from_py(
+        Float64NumpyArray toas,
+        std::optional<LabelNumpyArray<uint32_t>> labels,
+        uint32_t first_label
+    ) const {
+        if (!labels) {
+            labels = vec2numpy(std::vector<uint32_t>(toas.size(), 0));
+        }
+        std::vector<RADAR_ALGORITHM_NS::Emitter> emitters;
+        {
+            nb::gil_scoped_release release;
+            emitters = run(
+                { toas.data(), toas.size() },
+                { labels->data(), labels->size() },
+                first_label
+            );
+        }
+        return std::make_pair(*labels, std::move(emitters));
+    }
+};
+
+
+class PyShardedProcessor: public RADAR_ALGORITHM_NS::ShardedProcessor {
+public:
+    PyShardedProcessor(
+        RADAR_ALGORITHM_NS::EmitterExtractor chain,
+        double window,
+        double overlap,
+        double pri_toler,
+        double phase_toler,
+        size_t max_gap
+    ) noexcept:
+        RADAR_ALGORITHM_NS::ShardedProcessor(
+            thread_pool(),
+            std::move(chain),
+            window,
+            overlap,
+            pri_toler,
+            phase_toler,
+            max_gap
+        ) {}
+
+    std::pair<LabelNumpyArray<uint32_t>, std::vector<RADAR_ALGORITHM_NS::Track>>
+    run_from_py(Float64NumpyArray toas) const {
+        auto labels = vec2numpy(std::vector<uint32_t>(toas.size(), 0));
+        std::vector<RADAR_ALGORITHM_NS::Track> tracks;
+        {
+            nb::gil_scoped_release release;
+            tracks = run(
+                { toas.data(), toas.size() },
+                { labels.data(), labels.size() }
+            );
+        }
+        return std::make_pair(labels, std::move(tracks));
+    }
+};
+
+
+class PyTrackLibrary: public RADAR_ALGORITHM_NS::TrackLibrary {
+public:
+    PyTrackLibrary(
+        RADAR_ALGORITHM_NS::EmitterExtractor chain,
+        size_t thr,
+        double toler,
+        double allow_miss_rate,
+        size_t max_age
+    ) noexcept:
+        RADAR_ALGORITHM_NS::TrackLibrary(std::move(chain), thr, toler, allow_miss_rate, max_age) {}
+
+    std::pair<LabelNumpyArray<uint32_t>, std::vector<RADAR_ALGORITHM_NS::Emitter>>
+    process_from_py(Float64NumpyArray toas) {
+        auto labels = vec2numpy(std::vector<uint32_t>(toas.size(), 0));
+        std::vector<RADAR_ALGORITHM_NS::Emitter> emitters;
+        {
+            nb::gil_scoped_release release;
+            emitters = process(
+                { toas.data(), toas.size() },
+                { labels.data(), labels.size() }
+            );
+        }
+        return std::make_pair(labels, std::move(emitters));
+    }
+
+    std::vector<RADAR_ALGORITHM_NS::KnownEmitter> emitters_from_py() const {
+        nb::gil_scoped_release release;
+        return emitters();
+    }
+};
+
+
 NB_MODULE(PY_MODULE_NAME, m) {
     nb::enum_<spdlog::level::level_enum>(m, "LogLevel")
         .value("trace", spdlog::level::trace)
@@ -133,14 +755,176 @@ NB_MODULE(PY_MODULE_NAME, m) {
         nb::arg("level")
     );
 
+    // wait async tasks before interpreter finalized, they need gil to finish
+    nb::module_::import_("atexit").attr("register")(
+        nb::cpp_function([]() {
+            nb::gil_scoped_release release;
+            thread_pool().shutdown();
+        })
+    );
+
+    nb::class_<PyDifferenceHistogram>(m, "DifferenceHistogram")
+        .def(
+            nb::init<
+                Float64NumpyArray,
+                int,
+                double,
+                std::optional<std::pair<double, double>>
+            >(),
+            nb::arg("toas"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none(),
+            nb::call_guard<nb::gil_scoped_release>()
+        )
+        .def_prop_ro(
+            "pulse_num",
+            [](const PyDifferenceHistogram& hist) { return hist.pulse_num(); }
+        )
+        .def_prop_ro(
+            "duration",
+            [](const PyDifferenceHistogram& hist) { return hist.duration(); }
+        )
+        .def_prop_ro(
+            "max_rank",
+            [](const PyDifferenceHistogram& hist) { return hist.max_rank(); }
+        )
+        .def_prop_ro(
+            "bin_width",
+            [](const PyDifferenceHistogram& hist) { return hist.bin_width(); }
+        )
+        .def_prop_ro(
+            "bin_num",
+            [](const PyDifferenceHistogram& hist) { return hist.bin_num(); }
+        );
+
+    nb::class_<RADAR_ALGORITHM_NS::SamplingOptions>(m, "SamplingOptions")
+        .def(
+            nb::init<double, bool, uint64_t, double, size_t>(),
+            nb::arg("ratio") = 0.1,
+            nb::arg("stratified") = true,
+            nb::arg("seed") = (uint64_t)0,
+            nb::arg("z") = 1.96,
+            nb::arg("refine") = (size_t)16
+        )
+        .def_ro("ratio", &RADAR_ALGORITHM_NS::SamplingOptions::ratio)
+        .def_ro("stratified", &RADAR_ALGORITHM_NS::SamplingOptions::stratified)
+        .def_ro("seed", &RADAR_ALGORITHM_NS::SamplingOptions::seed)
+        .def_ro("z", &RADAR_ALGORITHM_NS::SamplingOptions::z)
+        .def_ro("refine", &RADAR_ALGORITHM_NS::SamplingOptions::refine);
+
+    nb::class_<PyPhaseHistogram>(m, "PhaseHistogram")
+        .def(
+            nb::init<Float64NumpyArray, std::pair<double, double>, double>(),
+            nb::arg("toas"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::call_guard<nb::gil_scoped_release>()
+        )
+        .def(
+            nb::init<
+                Float64NumpyArray,
+                std::pair<double, double>,
+                double,
+                const RADAR_ALGORITHM_NS::SamplingOptions&
+            >(),
+            nb::arg("toas"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("sampling"),
+            nb::call_guard<nb::gil_scoped_release>()
+        )
+        .def_prop_ro(
+            "pulse_num",
+            [](const PyPhaseHistogram& hist) { return hist.pulse_num(); }
+        )
+        .def_prop_ro(
+            "duration",
+            [](const PyPhaseHistogram& hist) { return hist.duration(); }
+        )
+        .def_prop_ro(
+            "range",
+            [](const PyPhaseHistogram& hist) { return hist.range(); }
+        )
+        .def_prop_ro(
+            "bin_width",
+            [](const PyPhaseHistogram& hist) { return hist.bin_width(); }
+        )
+        .def_prop_ro(
+            "magnitudes",
+            [](const PyPhaseHistogram& hist) {
+                std::vector<double> magnitudes;
+                for (auto bin : hist.bins()) {
+                    magnitudes.push_back(std::abs(bin));
+                }
+                return vec2numpy(std::move(magnitudes));
+            },
+            nb::rv_policy::move
+        )
+        .def_prop_ro(
+            "margins",
+            [](const PyPhaseHistogram& hist) {
+                auto margins = hist.margins();
+                return vec2numpy(std::vector<double>(margins.begin(), margins.end()));
+            },
+            nb::rv_policy::move
+        );
+
     nb::class_<PyPulseSearcher>(m, "PulseSearcher")
         .def(nb::init<size_t, double, double>(), nb::arg("thr"), nb::arg("toler"), nb::arg("allow_miss_rate"))
         .def(
             "run",
-            &PyPulseSearcher::run_from_py,
+            &PyPulseSearcher::run_from_py<uint8_t>,
+            nb::arg("pri"),
+            nb::arg("toas"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("label") = (uint8_t)1,
+            nb::rv_policy::move
+        )
+        .def(
+            "run",
+            &PyPulseSearcher::run_from_py<uint32_t>,
             nb::arg("pri"),
             nb::arg("toas"),
+            nb::arg("labels"),
+            nb::arg("label") = (uint32_t)1,
             nb::rv_policy::move
+        )
+        .def(
+            "predict",
+            &PyPulseSearcher::predict_from_py<uint8_t>,
+            nb::arg("pri"),
+            nb::arg("phase"),
+            nb::arg("toas"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("label") = (uint8_t)1,
+            nb::rv_policy::move
+        )
+        .def(
+            "predict",
+            &PyPulseSearcher::predict_from_py<uint32_t>,
+            nb::arg("pri"),
+            nb::arg("phase"),
+            nb::arg("toas"),
+            nb::arg("labels"),
+            nb::arg("label") = (uint32_t)1,
+            nb::rv_policy::move
+        )
+        .def(
+            "run_async",
+            &PyPulseSearcher::run_async_from_py<uint8_t>,
+            nb::arg("pri"),
+            nb::arg("toas"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("label") = (uint8_t)1
+        )
+        .def(
+            "run_async",
+            &PyPulseSearcher::run_async_from_py<uint32_t>,
+            nb::arg("pri"),
+            nb::arg("toas"),
+            nb::arg("labels"),
+            nb::arg("label") = (uint32_t)1
         );
 
     nb::class_<PyCDIF>(m, "CDIF")
@@ -150,7 +934,21 @@ NB_MODULE(PY_MODULE_NAME, m) {
             &PyCDIF::run_from_py,
             nb::arg("toas"),
             nb::arg("max_rank"),
-            nb::arg("bin_width")
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none()
+        )
+        .def(
+            "run_async",
+            &PyCDIF::run_async_from_py,
+            nb::arg("toas"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none()
+        )
+        .def(
+            "detect",
+            &PyCDIF::detect_from_py,
+            nb::arg("hist")
         );
 
     nb::class_<PySDIF>(m, "SDIF")
@@ -160,7 +958,21 @@ NB_MODULE(PY_MODULE_NAME, m) {
             &PySDIF::run_from_py,
             nb::arg("toas"),
             nb::arg("max_rank"),
-            nb::arg("bin_width")
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none()
+        )
+        .def(
+            "run_async",
+            &PySDIF::run_async_from_py,
+            nb::arg("toas"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none()
+        )
+        .def(
+            "detect",
+            &PySDIF::detect_from_py,
+            nb::arg("hist")
         );
 
     nb::class_<PyPRITransform>(m, "PRITransform")
@@ -170,18 +982,288 @@ NB_MODULE(PY_MODULE_NAME, m) {
             &PyPRITransform::run_from_py,
             nb::arg("toas"),
             nb::arg("range"),
-            nb::arg("bin_width")
+            nb::arg("bin_width"),
+            nb::arg("sampling") = nb::none()
+        )
+        .def(
+            "run_async",
+            &PyPRITransform::run_async_from_py,
+            nb::arg("toas"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("sampling") = nb::none()
+        )
+        .def(
+            "detect",
+            &PyPRITransform::detect_from_py,
+            nb::arg("hist")
         );
 
     nb::class_<PyPulseCorrelation>(m, "PulseCorrelation")
         .def(nb::init<size_t, size_t>(), nb::arg("min_chain"), nb::arg("thr"))
         .def(
             "run",
-            &PyPulseCorrelation::run_from_py,
+            &PyPulseCorrelation::run_from_py<uint8_t>,
+            nb::arg("toas"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("merge_num"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("label") = (uint8_t)1,
+            nb::arg("sampling") = nb::none(),
+            nb::rv_policy::move
+        )
+        .def(
+            "run",
+            &PyPulseCorrelation::run_from_py<uint32_t>,
             nb::arg("toas"),
             nb::arg("range"),
             nb::arg("bin_width"),
             nb::arg("merge_num"),
+            nb::arg("labels"),
+            nb::arg("label") = (uint32_t)1,
+            nb::arg("sampling") = nb::none(),
             nb::rv_policy::move
+        )
+        .def(
+            "run_async",
+            &PyPulseCorrelation::run_async_from_py<uint8_t>,
+            nb::arg("toas"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("merge_num"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("label") = (uint8_t)1,
+            nb::arg("sampling") = nb::none()
+        )
+        .def(
+            "run_async",
+            &PyPulseCorrelation::run_async_from_py<uint32_t>,
+            nb::arg("toas"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("merge_num"),
+            nb::arg("labels"),
+            nb::arg("label") = (uint32_t)1,
+            nb::arg("sampling") = nb::none()
+        );
+
+    nb::class_<RADAR_ALGORITHM_NS::SweepRecord>(m, "SweepRecord")
+        .def_ro("params", &RADAR_ALGORITHM_NS::SweepRecord::params)
+        .def_ro("accuracy", &RADAR_ALGORITHM_NS::SweepRecord::accuracy)
+        .def_ro("runtime", &RADAR_ALGORITHM_NS::SweepRecord::runtime);
+
+    nb::class_<PyParameterSweeper>(m, "ParameterSweeper")
+        .def(nb::init<double>(), nb::arg("pri_toler"))
+        .def(
+            "sweep_sdif",
+            &PyParameterSweeper::sweep_sdif_from_py,
+            nb::arg("datasets"),
+            nb::arg("xs"),
+            nb::arg("ks"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width")
+        )
+        .def(
+            "sweep_cdif",
+            &PyParameterSweeper::sweep_cdif_from_py,
+            nb::arg("datasets"),
+            nb::arg("ks"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width")
+        )
+        .def(
+            "sweep_pri_transform",
+            &PyParameterSweeper::sweep_pri_transform_from_py,
+            nb::arg("datasets"),
+            nb::arg("alphas"),
+            nb::arg("betas"),
+            nb::arg("gammas"),
+            nb::arg("range"),
+            nb::arg("bin_width")
+        )
+        .def(
+            "sweep_pulse_searcher",
+            &PyParameterSweeper::sweep_pulse_searcher_from_py,
+            nb::arg("datasets"),
+            nb::arg("thrs"),
+            nb::arg("tolers"),
+            nb::arg("allow_miss_rates")
+        )
+        .def(
+            "sweep_pulse_correlation",
+            &PyParameterSweeper::sweep_pulse_correlation_from_py,
+            nb::arg("datasets"),
+            nb::arg("min_chains"),
+            nb::arg("thrs"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("merge_num")
+        );
+
+    nb::class_<RADAR_ALGORITHM_NS::Emitter>(m, "Emitter")
+        .def_ro("label", &RADAR_ALGORITHM_NS::Emitter::label)
+        .def_ro("pri", &RADAR_ALGORITHM_NS::Emitter::pri)
+        .def_ro("first_toa", &RADAR_ALGORITHM_NS::Emitter::first_toa)
+        .def_ro("last_toa", &RADAR_ALGORITHM_NS::Emitter::last_toa)
+        .def_ro("pulse_num", &RADAR_ALGORITHM_NS::Emitter::pulse_num);
+
+    nb::class_<PyEmitterChain>(m, "EmitterChain")
+        .def_static(
+            "from_sdif",
+            &PyEmitterChain::from_sdif,
+            nb::arg("sdif"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("searcher"),
+            nb::arg("max_emitter"),
+            nb::arg("range") = nb::none()
+        )
+        .def_static(
+            "from_cdif",
+            &PyEmitterChain::from_cdif,
+            nb::arg("cdif"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("searcher"),
+            nb::arg("max_emitter"),
+            nb::arg("range") = nb::none()
+        )
+        .def_static(
+            "from_pri_transform",
+            &PyEmitterChain::from_pri_transform,
+            nb::arg("transform"),
+            nb::arg("range"),
+            nb::arg("bin_width"),
+            nb::arg("searcher"),
+            nb::arg("max_emitter")
+        )
+        .def(
+            "run",
+            &PyEmitterChain::run_from_py,
+            nb::arg("toas"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("first_label") = (uint32_t)1
+        );
+
+    nb::class_<RADAR_ALGORITHM_NS::Track>(m, "Track")
+        .def_ro("label", &RADAR_ALGORITHM_NS::Track::label)
+        .def_ro("pri", &RADAR_ALGORITHM_NS::Track::pri)
+        .def_ro("first_toa", &RADAR_ALGORITHM_NS::Track::first_toa)
+        .def_ro("last_toa", &RADAR_ALGORITHM_NS::Track::last_toa)
+        .def_ro("pulse_num", &RADAR_ALGORITHM_NS::Track::pulse_num);
+
+    nb::class_<PyShardedProcessor>(m, "ShardedProcessor")
+        .def(
+            nb::init<const PyEmitterChain&, double, double, double, double, size_t>(),
+            nb::arg("chain"),
+            nb::arg("window"),
+            nb::arg("overlap"),
+            nb::arg("pri_toler"),
+            nb::arg("phase_toler"),
+            nb::arg("max_gap") = (size_t)0
+        )
+        .def(
+            nb::init<const PyPipeline&, double, double, double, double, size_t>(),
+            nb::arg("chain"),
+            nb::arg("window"),
+            nb::arg("overlap"),
+            nb::arg("pri_toler"),
+            nb::arg("phase_toler"),
+            nb::arg("max_gap") = (size_t)0
+        )
+        .def(
+            "run",
+            &PyShardedProcessor::run_from_py,
+            nb::arg("toas")
+        );
+
+    nb::class_<RADAR_ALGORITHM_NS::KnownEmitter>(m, "KnownEmitter")
+        .def_ro("id", &RADAR_ALGORITHM_NS::KnownEmitter::id)
+        .def_ro("pri", &RADAR_ALGORITHM_NS::KnownEmitter::pri)
+        .def_ro("phase", &RADAR_ALGORITHM_NS::KnownEmitter::phase)
+        .def_ro("toler", &RADAR_ALGORITHM_NS::KnownEmitter::toler)
+        .def_ro("age", &RADAR_ALGORITHM_NS::KnownEmitter::age);
+
+    nb::class_<PyTrackLibrary>(m, "TrackLibrary")
+        .def(
+            nb::init<const PyEmitterChain&, size_t, double, double, size_t>(),
+            nb::arg("chain"),
+            nb::arg("thr"),
+            nb::arg("toler"),
+            nb::arg("allow_miss_rate"),
+            nb::arg("max_age")
+        )
+        .def(
+            nb::init<const PyPipeline&, size_t, double, double, size_t>(),
+            nb::arg("chain"),
+            nb::arg("thr"),
+            nb::arg("toler"),
+            nb::arg("allow_miss_rate"),
+            nb::arg("max_age")
+        )
+        .def(
+            "process",
+            &PyTrackLibrary::process_from_py,
+            nb::arg("toas")
+        )
+        .def_prop_ro("emitters", &PyTrackLibrary::emitters_from_py)
+        .def(
+            "clear",
+            [](PyTrackLibrary& library) { library.clear(); },
+            nb::call_guard<nb::gil_scoped_release>()
+        );
+
+    nb::class_<RADAR_ALGORITHM_NS::SDIFStage<>>(m, "SDIFStage")
+        .def(
+            nb::init<const PySDIF&, int, double, std::optional<std::pair<double, double>>>(),
+            nb::arg("sdif"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none()
+        );
+    nb::class_<RADAR_ALGORITHM_NS::CDIFStage<>>(m, "CDIFStage")
+        .def(
+            nb::init<const PyCDIF&, int, double, std::optional<std::pair<double, double>>>(),
+            nb::arg("cdif"),
+            nb::arg("max_rank"),
+            nb::arg("bin_width"),
+            nb::arg("range") = nb::none()
+        );
+    nb::class_<RADAR_ALGORITHM_NS::PRITransformStage>(m, "PRITransformStage")
+        .def(
+            nb::init<const PyPRITransform&, std::pair<double, double>, double>(),
+            nb::arg("transform"),
+            nb::arg("range"),
+            nb::arg("bin_width")
+        );
+    nb::class_<RADAR_ALGORITHM_NS::PulseSearcherStage>(m, "PulseSearcherStage")
+        .def(nb::init<const PyPulseSearcher&>(), nb::arg("searcher"));
+    nb::class_<RADAR_ALGORITHM_NS::PulseCorrelationStage>(m, "PulseCorrelationStage")
+        .def(
+            nb::init<const PyPulseCorrelation&, double, size_t, double>(),
+            nb::arg("correlation"),
+            nb::arg("bin_width"),
+            nb::arg("merge_num"),
+            nb::arg("toler")
+        );
+
+    nb::class_<PyPipeline>(m, "Pipeline")
+        .def(
+            nb::init<
+                std::vector<RADAR_ALGORITHM_NS::AnyEstimatorStage::Stage>,
+                RADAR_ALGORITHM_NS::AnyExtractorStage::Stage,
+                size_t
+            >(),
+            nb::arg("estimators"),
+            nb::arg("extractor"),
+            nb::arg("max_emitter")
+        )
+        .def(
+            "run",
+            &PyPipeline::run_from_py,
+            nb::arg("toas"),
+            nb::arg("labels") = nb::none(),
+            nb::arg("first_label") = (uint32_t)1
         );
 }
@@ -1,6 +1,3 @@
-#include <vector>
-#include <cmath>
-
 #include <spdlog/spdlog.h>
 
 #include "radar_algorithm_ns.hpp"
@@ -22,47 +19,46 @@ CDIF::CDIF(double k) noexcept:
 std::optional<double> CDIF::run(
     std::span<double> data,
     int max_rank,
-    double bin_width
+    double bin_width,
+    std::optional<std::pair<double, double>> range
 ) const noexcept {
     if (data.size() < 2) {
         return std::nullopt;
     }
-
-    auto logger = spdlog::default_logger();
-    auto start_toa = data[0];
-    auto end_toa = data.back();
-    auto duration = end_toa - start_toa;
-    auto bin_num = (size_t)std::ceil(duration / bin_width);
-    std::vector<double> hist;
-    hist.reserve(bin_num);
-    // initialize hist with minus threshold
-    {
-        double center = bin_width / 2;
-        for (size_t i = 0; i < bin_num; i++) {
-            hist.push_back(-_k*duration/center);
-            center += bin_width;
-        }
-    }
-
+    // build rank by rank, so that higher ranks are never enumerated once
+    // pri detected
+    DifferenceHistogram rank_hist(data, 0, bin_width, range);
+    RankState state;
     for (int rank = 1; rank <= max_rank; rank++) {
-        logger->debug("rank {}", rank);
-        for (size_t i = 0; i < data.size()-rank; i++) {
-            auto dtoa = data[i+rank] - data[i];
-            auto idx = (size_t)std::floor(dtoa / bin_width);
-            hist[idx] += 1;
+        rank_hist.add_rank(data);
+        if (auto pri = detect_rank(rank_hist, rank, state)) {
+            return pri;
         }
+    }
+    return std::nullopt;
+}
 
-        for (size_t i = 0; i < bin_num; i++) {
-            if (
-                hist[i] > 0
-                and (hist[2*i] > 0 or hist[2*i+1] > 0)
-            ) {
-                auto pri = (i+0.5)*bin_width;
-                return std::make_optional(pri);
-            }
+std::optional<double> CDIF::detect(const DifferenceHistogram& rank_hist) const noexcept {
+    if (rank_hist.pulse_num() < 2) {
+        return std::nullopt;
+    }
+    RankState state;
+    for (int rank = 1; rank <= rank_hist.max_rank(); rank++) {
+        if (auto pri = detect_rank(rank_hist, rank, state)) {
+            return pri;
         }
     }
     return std::nullopt;
 }
 
+std::optional<double> CDIF::detect_rank(
+    const DifferenceHistogram& rank_hist,
+    int rank,
+    RankState& state
+) const noexcept {
+    auto logger = spdlog::default_logger();
+    logger->debug("rank {}", rank);
+    return _detect_rank(rank_hist, rank, state);
+}
+
 RADAR_ALGORITHM_NS_END
@@ -0,0 +1,267 @@
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "pair_enumeration.hpp"
+#include "radar_algorithm/histogram.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// @brief count bin indices into sorted touched bins
+/// @param idxs: bin index of each pair, will be reordered
+/// @param dense: buffer to count by bins directly when index span is narrow
+/// @param bins: touched bins appended to
+static void count_bins(
+    std::vector<size_t>& idxs,
+    std::vector<size_t>& dense,
+    std::vector<DifferenceHistogram::Bin>& bins
+) noexcept {
+    if (idxs.empty()) {
+        return;
+    }
+
+    auto [min_it, max_it] = std::minmax_element(idxs.begin(), idxs.end());
+    auto first = *min_it;
+    auto span = *max_it - first + 1;
+    // count directly if bins not much more than indices, sort otherwise
+    if (span <= 4*idxs.size()) {
+        dense.assign(span, 0);
+        for (auto idx : idxs) {
+            dense[idx-first]++;
+        }
+        for (size_t i = 0; i < span; i++) {
+            if (dense[i]) {
+                bins.emplace_back(first+i, dense[i]);
+            }
+        }
+        return;
+    }
+
+    std::sort(idxs.begin(), idxs.end());
+    for (auto idx : idxs) {
+        if (bins.empty() or bins.back().idx != idx) {
+            bins.emplace_back(idx, 0);
+        }
+        bins.back().count++;
+    }
+}
+
+DifferenceHistogram::DifferenceHistogram(
+    std::span<double> data,
+    int max_rank,
+    double bin_width,
+    std::optional<std::pair<double, double>> range
+) noexcept:
+    _pulse_num(data.size()),
+    _duration(data.size() < 2 ? 0 : data.back()-data[0]),
+    _bin_width(bin_width),
+    _bin_num((size_t)std::ceil(_duration / bin_width)),
+    _search_bins(0, _bin_num),
+    _lower(0),
+    _upper(std::numeric_limits<double>::infinity())
+{
+    // CDIF check bins of twice pri for subharmonic,
+    // so keep difference up to twice of range
+    if (range) {
+        _search_bins.first = std::min(
+            (size_t)std::floor(std::max(range->first, 0.0)/bin_width),
+            _bin_num
+        );
+        _search_bins.second = std::clamp(
+            (size_t)std::floor(std::max(range->second, 0.0)/bin_width)+1,
+            _search_bins.first,
+            _bin_num
+        );
+        _lower = _search_bins.first*bin_width;
+        _upper = 2*range->second + 2*bin_width;
+    }
+
+    _offsets.reserve(std::max(max_rank, 0)+1);
+    _offsets.push_back(0);
+    for (int rank = 1; rank <= max_rank; rank++) {
+        add_rank(data);
+    }
+}
+
+void DifferenceHistogram::add_rank(std::span<double> data) noexcept {
+    std::vector<size_t> idxs;
+    std::vector<size_t> dense;
+    detail::BinIndexAccumulator acc { idxs, _lower, _upper, _bin_width };
+    detail::enumerate_rank_pairs(data, max_rank()+1, acc);
+    count_bins(idxs, dense, _bins);
+    _offsets.push_back(_bins.size());
+}
+
+size_t DifferenceHistogram::pulse_num() const noexcept {
+    return _pulse_num;
+}
+
+double DifferenceHistogram::duration() const noexcept {
+    return _duration;
+}
+
+int DifferenceHistogram::max_rank() const noexcept {
+    return (int)_offsets.size() - 1;
+}
+
+double DifferenceHistogram::bin_width() const noexcept {
+    return _bin_width;
+}
+
+size_t DifferenceHistogram::bin_num() const noexcept {
+    return _bin_num;
+}
+
+std::pair<size_t, size_t> DifferenceHistogram::search_bins() const noexcept {
+    return _search_bins;
+}
+
+std::span<const DifferenceHistogram::Bin> DifferenceHistogram::rank(int rank) const noexcept {
+    return std::span<const Bin>(_bins).subspan(
+        _offsets[rank-1],
+        _offsets[rank]-_offsets[rank-1]
+    );
+}
+
+
+PhaseHistogram::PhaseHistogram(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width
+) noexcept:
+    _pulse_num(data.size()),
+    _duration(data.size() < 2 ? 0 : data.back()-data[0]),
+    _range(range),
+    _bin_width(bin_width)
+{
+    if (data.size() < 2) {
+        return;
+    }
+
+    auto bin_num = (size_t)std::ceil((range.second-range.first)/bin_width)+1;
+    _hist.resize(bin_num);
+    detail::PhaseAccumulator acc { data, _hist, range.first, bin_width };
+    detail::enumerate_range_pairs(data, range, acc);
+}
+
+PhaseHistogram::PhaseHistogram(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width,
+    const SamplingOptions& sampling
+) noexcept:
+    _pulse_num(data.size()),
+    _duration(data.size() < 2 ? 0 : data.back()-data[0]),
+    _range(range),
+    _bin_width(bin_width)
+{
+    auto logger = spdlog::default_logger();
+    if (sampling.ratio <= 0 or sampling.ratio > 1) {
+        logger->warn("`ratio` should between (0, 1], but got {}", sampling.ratio);
+    }
+    if (data.size() < 2) {
+        return;
+    }
+
+    auto bin_num = (size_t)std::ceil((range.second-range.first)/bin_width)+1;
+    _hist.resize(bin_num);
+    std::vector<size_t> candidates(data.size()-1);
+    std::iota(candidates.begin(), candidates.end(), 0);
+    auto heads = detail::sample_heads(
+        candidates,
+        sampling.ratio,
+        sampling.stratified,
+        sampling.seed
+    );
+    logger->debug("sample {} of {} heads", heads.size(), candidates.size());
+
+    std::vector<double> square(bin_num, 0);
+    detail::SampledAccumulator acc(
+        std::span<std::complex<double>>(_hist),
+        std::span<double>(square),
+        [&](const detail::ToaPair& pair, auto&& add) noexcept {
+            auto idx = (size_t)std::floor((pair.dtoa-range.first)/bin_width);
+            if (idx < bin_num) [[likely]] {
+                add(idx, detail::pair_phase(data, pair));
+            }
+        }
+    );
+    detail::enumerate_head_pairs(data, heads, range, acc);
+    acc.finish_head();
+    _margins = detail::scale_estimation(
+        std::span(_hist),
+        std::span<const double>(square),
+        heads.size(),
+        candidates.size(),
+        sampling.z
+    );
+
+    // recompute bins most likely to exceed threshold exactly
+    std::vector<size_t> order(bin_num);
+    std::iota(order.begin(), order.end(), 0);
+    // nothing to refine if all heads sampled
+    auto refine_num = heads.size() == candidates.size()
+        ? 0
+        : std::min(sampling.refine, bin_num);
+    std::partial_sort(
+        order.begin(),
+        order.begin()+refine_num,
+        order.end(),
+        [this](size_t i, size_t j) noexcept {
+            return std::norm(_hist[i]) > std::norm(_hist[j]);
+        }
+    );
+    for (size_t k = 0; k < refine_num; k++) {
+        auto idx = order[k];
+        std::complex<double> value = 0;
+        auto exact = [&](std::span<const detail::ToaPair> pairs) noexcept {
+            for (auto& pair : pairs) {
+                if ((size_t)std::floor((pair.dtoa-range.first)/bin_width) == idx) {
+                    value += detail::pair_phase(data, pair);
+                }
+            }
+        };
+        // widen by one bin so pairs on bin edge are decided as above
+        auto lower = range.first + idx*bin_width;
+        detail::enumerate_range_pairs(
+            data,
+            {
+                std::max(range.first, lower-bin_width),
+                std::min(range.second, lower+2*bin_width)
+            },
+            exact
+        );
+        _hist[idx] = value;
+        _margins[idx] = 0;
+    }
+}
+
+size_t PhaseHistogram::pulse_num() const noexcept {
+    return _pulse_num;
+}
+
+double PhaseHistogram::duration() const noexcept {
+    return _duration;
+}
+
+std::pair<double, double> PhaseHistogram::range() const noexcept {
+    return _range;
+}
+
+double PhaseHistogram::bin_width() const noexcept {
+    return _bin_width;
+}
+
+std::span<const std::complex<double>> PhaseHistogram::bins() const noexcept {
+    return _hist;
+}
+
+std::span<const double> PhaseHistogram::margins() const noexcept {
+    return _margins;
+}
+
+RADAR_ALGORITHM_NS_END
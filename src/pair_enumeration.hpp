@@ -0,0 +1,385 @@
+#pragma once
+#include <span>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <random>
+#include <cstdint>
+#include <complex>
+#include <numbers>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include "radar_algorithm_ns.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN(detail)
+
+/// pulse pair produced by enumeration, `head` always less than `tail`
+struct ToaPair {
+    size_t head, tail;
+    double dtoa;
+};
+
+/// number of pairs buffered before being fed to accumulator,
+/// 512 pairs take 12KB which fit in L1 cache together with hist lines
+inline constexpr size_t PAIR_BLOCK_SIZE = 512;
+
+/// skip nothing
+struct NoSkip {
+    constexpr bool operator()(size_t) const noexcept { return false; }
+};
+
+/// buffer pairs and flush them to accumulator block by block
+template<typename Accumulator>
+class PairBlock {
+public:
+    explicit PairBlock(Accumulator& acc) noexcept: _acc(acc) {}
+    ~PairBlock() noexcept { flush(); }
+
+    void push(size_t head, size_t tail, double dtoa) noexcept {
+        _pairs[_size++] = { head, tail, dtoa };
+        if (_size == _pairs.size()) [[unlikely]] {
+            flush();
+        }
+    }
+
+    void flush() noexcept {
+        if (_size) {
+            _acc(std::span<const ToaPair>(_pairs.data(), _size));
+            _size = 0;
+        }
+    }
+private:
+    Accumulator& _acc;
+    std::array<ToaPair, PAIR_BLOCK_SIZE> _pairs;
+    size_t _size = 0;
+};
+
+/// @brief enumerate all pulse pairs whose toa difference between `range`,
+///     pairs are fed in order of head first and tail second
+/// @param data: sorted toa
+/// @param range: toa difference range, both side included
+/// @param skip: predicate on pulse index, pulse satisfied will not be paired
+/// @param acc: accumulator called with span of pairs
+template<typename Accumulator, typename Skip = NoSkip>
+void enumerate_range_pairs(
+    std::span<const double> data,
+    std::pair<double, double> range,
+    Accumulator& acc,
+    Skip skip = Skip()
+) noexcept {
+    PairBlock<Accumulator> block(acc);
+    // first tail whose difference to head not less than `range.first`,
+    // it only moves forward since data is sorted
+    size_t first = 1;
+    for (size_t head = 0; head+1 < data.size(); head++) {
+        if (skip(head)) {
+            continue;
+        }
+
+        first = std::max(first, head+1);
+        while (first < data.size() and data[first]-data[head] < range.first) {
+            first++;
+        }
+        for (size_t tail = first; tail < data.size(); tail++) {
+            auto dtoa = data[tail] - data[head];
+            if (dtoa > range.second) {
+                break;
+            }
+            if (skip(tail)) {
+                continue;
+            }
+            block.push(head, tail, dtoa);
+        }
+    }
+}
+
+/// @brief enumerate pairs whose toa difference between `range` for given
+///     heads only, pairs are fed in order of head first and tail second
+/// @param data: sorted toa
+/// @param heads: sorted index of heads
+/// @param range: toa difference range, both side included
+/// @param skip: predicate on pulse index, pulse satisfied will not be tail
+/// @param acc: accumulator called with span of pairs
+template<typename Accumulator, typename Skip = NoSkip>
+void enumerate_head_pairs(
+    std::span<const double> data,
+    std::span<const size_t> heads,
+    std::pair<double, double> range,
+    Accumulator& acc,
+    Skip skip = Skip()
+) noexcept {
+    PairBlock<Accumulator> block(acc);
+    size_t first = 1;
+    for (auto head : heads) {
+        first = std::max(first, head+1);
+        while (first < data.size() and data[first]-data[head] < range.first) {
+            first++;
+        }
+        for (size_t tail = first; tail < data.size(); tail++) {
+            auto dtoa = data[tail] - data[head];
+            if (dtoa > range.second) {
+                break;
+            }
+            if (skip(tail)) {
+                continue;
+            }
+            block.push(head, tail, dtoa);
+        }
+    }
+}
+
+/// @brief enumerate pulse pairs `rank` pulses apart
+/// @param data: sorted toa
+/// @param rank: index difference of pair
+/// @param acc: accumulator called with span of pairs
+template<typename Accumulator>
+void enumerate_rank_pairs(
+    std::span<const double> data,
+    size_t rank,
+    Accumulator& acc
+) noexcept {
+    PairBlock<Accumulator> block(acc);
+    for (size_t head = 0; head+rank < data.size(); head++) {
+        block.push(head, head+rank, data[head+rank]-data[head]);
+    }
+}
+
+/// count pairs into bins of `bin_width` start from `offset`
+template<typename T>
+struct CountAccumulator {
+    std::span<T> hist;
+    double offset;
+    double bin_width;
+
+    void operator()(std::span<const ToaPair> pairs) noexcept {
+        for (auto& pair : pairs) {
+            auto idx = (size_t)std::floor((pair.dtoa-offset)/bin_width);
+            if (idx < hist.size()) [[likely]] {
+                hist[idx] += 1;
+            }
+        }
+    }
+};
+
+/// collect bin index of pairs whose difference between [`lower`, `upper`)
+struct BinIndexAccumulator {
+    std::vector<size_t>& idxs;
+    double lower;
+    double upper;
+    double bin_width;
+
+    void operator()(std::span<const ToaPair> pairs) {
+        for (auto& pair : pairs) {
+            if (pair.dtoa >= lower and pair.dtoa < upper) {
+                idxs.push_back((size_t)std::floor(pair.dtoa/bin_width));
+            }
+        }
+    }
+};
+
+/// phase of pair used by pri transform
+inline std::complex<double> pair_phase(
+    std::span<const double> data,
+    const ToaPair& pair
+) noexcept {
+    constexpr auto two_pi = std::numbers::pi * 2;
+    auto theta = two_pi*(data[pair.tail]/std::max(pair.dtoa, 1e-9));
+    return { std::cos(theta), std::sin(theta) };
+}
+
+/// accumulate phase of pairs into bins, as pri transform does
+struct PhaseAccumulator {
+    std::span<const double> data;
+    std::span<std::complex<double>> hist;
+    double offset;
+    double bin_width;
+
+    void operator()(std::span<const ToaPair> pairs) noexcept {
+        for (auto& pair : pairs) {
+            auto idx = (size_t)std::floor((pair.dtoa-offset)/bin_width);
+            if (idx >= hist.size()) [[unlikely]] {
+                continue;
+            }
+            hist[idx] += pair_phase(data, pair);
+        }
+    }
+};
+
+struct PulsePair {
+    size_t head, tail;
+};
+using PairBin = std::vector<PulsePair>;
+
+/// store pairs into bins, each pair also stored into `merge_num` bins before
+struct PairListAccumulator {
+    std::span<PairBin> hist;
+    double offset;
+    double bin_width;
+    size_t merge_num;
+
+    void operator()(std::span<const ToaPair> pairs) noexcept {
+        for (auto& pair : pairs) {
+            auto idx = (size_t)std::floor((pair.dtoa-offset)/bin_width);
+            if (idx >= hist.size()) [[unlikely]] {
+                continue;
+            }
+            size_t max_offset = std::min(idx, merge_num);
+            for (size_t offset = 0; offset < max_offset; offset++) {
+                hist[idx-offset].emplace_back(pair.head, pair.tail);
+            }
+        }
+    }
+};
+
+/// @brief sample heads from candidates
+/// @param candidates: sorted index of pulses could be head
+/// @param ratio: fraction of candidates to sample, at least one is sampled
+/// @param stratified: pick one from each of equal sized strata if true,
+///     otherwise pick uniformly without replacement
+/// @param seed: seed of random generator
+/// @return: sorted index of sampled heads
+inline std::vector<size_t> sample_heads(
+    std::span<const size_t> candidates,
+    double ratio,
+    bool stratified,
+    uint64_t seed
+) {
+    if (candidates.empty()) {
+        return {};
+    }
+    auto num = std::clamp<size_t>(
+        (size_t)std::round(ratio*candidates.size()),
+        1,
+        candidates.size()
+    );
+    std::mt19937_64 rng(seed);
+    std::vector<size_t> heads;
+    heads.reserve(num);
+    if (stratified) {
+        for (size_t k = 0; k < num; k++) {
+            auto begin = k*candidates.size()/num;
+            auto end = (k+1)*candidates.size()/num;
+            std::uniform_int_distribution<size_t> dist(begin, end-1);
+            heads.push_back(candidates[dist(rng)]);
+        }
+    } else {
+        std::sample(
+            candidates.begin(),
+            candidates.end(),
+            std::back_inserter(heads),
+            num,
+            rng
+        );
+    }
+    return heads;
+}
+
+/// @brief accumulate contribution of sampled heads into bins, together with
+///     sum of squared contribution of each head, so that variance of
+///     estimation could be calculated, pairs must be fed head by head
+/// @tparam Contribute: callable with pair and `add(idx, value)`
+template<typename T, typename Contribute>
+class SampledAccumulator {
+public:
+    SampledAccumulator(
+        std::span<T> hist,
+        std::span<double> square,
+        Contribute contribute
+    ):
+        _hist(hist),
+        _square(square),
+        _contribute(std::move(contribute)),
+        _head_hist(hist.size()),
+        _touched_flags(hist.size(), 0)
+    {}
+
+    void operator()(std::span<const ToaPair> pairs) noexcept {
+        auto add = [this](size_t idx, T value) noexcept {
+            if (!_touched_flags[idx]) {
+                _touched_flags[idx] = 1;
+                _touched.push_back(idx);
+            }
+            _head_hist[idx] += value;
+        };
+        for (auto& pair : pairs) {
+            if (pair.head != _head) {
+                finish_head();
+                _head = pair.head;
+            }
+            _contribute(pair, add);
+        }
+    }
+
+    /// @brief move contribution of current head into bins,
+    ///     must be called once enumeration finished
+    void finish_head() noexcept {
+        for (auto idx : _touched) {
+            _hist[idx] += _head_hist[idx];
+            _square[idx] += std::norm(_head_hist[idx]);
+            _head_hist[idx] = T();
+            _touched_flags[idx] = 0;
+        }
+        _touched.clear();
+    }
+private:
+    std::span<T> _hist;
+    std::span<double> _square;
+    Contribute _contribute;
+    std::vector<T> _head_hist;
+    std::vector<uint8_t> _touched_flags;
+    std::vector<size_t> _touched;
+    size_t _head = std::numeric_limits<size_t>::max();
+};
+
+/// @brief scale sums of sampled heads to estimation of whole population,
+///     heads are treated as simple random sample, which is conservative
+///     for stratified sampling, bin reached by no sampled head is bounded
+///     by Wilson upper bound of rate of heads reaching it, assuming each
+///     such head contributes one pair
+/// @param hist: sum of sampled contribution, replaced by estimation
+/// @param square: sum of squared contribution of each sampled head
+/// @param sample_num: number of sampled heads
+/// @param population: number of candidate heads
+/// @param z: z score of confidence bound
+/// @return: confidence bound of magnitude of each bin
+template<typename T>
+std::vector<double> scale_estimation(
+    std::span<T> hist,
+    std::span<const double> square,
+    size_t sample_num,
+    size_t population,
+    double z
+) {
+    std::vector<double> margins(hist.size(), 0);
+    if (sample_num == 0) {
+        return margins;
+    }
+    auto n = (double)sample_num;
+    auto scale = (double)population / n;
+    // finite population correction
+    auto correction = 1 - n/population;
+    for (size_t i = 0; i < hist.size(); i++) {
+        auto mean = hist[i] / n;
+        hist[i] *= scale;
+        if (sample_num == population) {
+            continue;
+        }
+        if (square[i] == 0) {
+            margins[i] = population * z*z/(n+z*z);
+            continue;
+        }
+        if (sample_num < 2) {
+            margins[i] = std::numeric_limits<double>::infinity();
+            continue;
+        }
+        auto variance = std::max(0., (square[i]-n*std::norm(mean)) / (n-1));
+        margins[i] = z*population*std::sqrt(correction*variance/n);
+    }
+    return margins;
+}
+
+RADAR_ALGORITHM_NS_END
@@ -0,0 +1,126 @@
+#include <cmath>
+
+#include <spdlog/spdlog.h>
+
+#include "radar_algorithm/pipeline.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+Emitter make_emitter(
+    std::span<const double> data,
+    std::span<const uint32_t> labels,
+    uint32_t label,
+    double pri
+) noexcept {
+    // refine pri by least squares fit of extracted pulses against their
+    // period index, estimated pri is only accurate to bin width
+    Emitter emitter { label, pri, 0, 0, 0 };
+    double n = 0, sum_n = 0, sum_t = 0, sum_nn = 0, sum_nt = 0;
+    for (size_t i = 0; i < data.size(); i++) {
+        if (labels[i] != label) {
+            continue;
+        }
+        if (emitter.pulse_num == 0) {
+            emitter.first_toa = data[i];
+        } else {
+            n += std::max(std::round((data[i]-emitter.last_toa) / pri), 1.0);
+        }
+        emitter.last_toa = data[i];
+        emitter.pulse_num++;
+        auto t = data[i] - emitter.first_toa;
+        sum_n += n;
+        sum_t += t;
+        sum_nn += n*n;
+        sum_nt += n*t;
+    }
+    double count = emitter.pulse_num;
+    auto var = count*sum_nn - sum_n*sum_n;
+    if (count > 1 and var > 0) {
+        emitter.pri = (count*sum_nt - sum_n*sum_t) / var;
+    }
+    return emitter;
+}
+
+
+bool PipelineContext::bind(std::span<double> data, std::span<uint32_t> labels) noexcept {
+    auto logger = spdlog::default_logger();
+    if (labels.size() != data.size()) [[unlikely]] {
+        logger->error(
+            "size of labels({}) not equal to size of data({})",
+            labels.size(),
+            data.size()
+        );
+        return false;
+    }
+    _data = data;
+    _labels = labels;
+    _residue.reserve(data.size());
+    return true;
+}
+
+void PipelineContext::update_residue() noexcept {
+    _residue.clear();
+    for (size_t i = 0; i < _data.size(); i++) {
+        if (!_labels[i]) {
+            _residue.push_back(_data[i]);
+        }
+    }
+    _difference.reset();
+    _phase.reset();
+}
+
+std::span<double> PipelineContext::data() const noexcept {
+    return _data;
+}
+
+std::span<uint32_t> PipelineContext::labels() const noexcept {
+    return _labels;
+}
+
+std::span<double> PipelineContext::residue() noexcept {
+    return _residue;
+}
+
+const DifferenceHistogram& PipelineContext::difference_histogram(
+    int rank,
+    double bin_width,
+    std::optional<std::pair<double, double>> range
+) noexcept {
+    if (
+        !_difference
+        or _difference->bin_width() != bin_width
+        or _difference_range != range
+    ) {
+        _difference.emplace(_residue, 0, bin_width, range);
+        _difference_range = range;
+    }
+    while (_difference->max_rank() < rank) {
+        auto logger = spdlog::default_logger();
+        logger->debug(
+            "build rank {} of difference histogram of {} pulses",
+            _difference->max_rank()+1,
+            _residue.size()
+        );
+        _difference->add_rank(_residue);
+    }
+    return *_difference;
+}
+
+const PhaseHistogram& PipelineContext::phase_histogram(
+    std::pair<double, double> range,
+    double bin_width
+) noexcept {
+    if (
+        !_phase
+        or _phase->range() != range
+        or _phase->bin_width() != bin_width
+    ) {
+        auto logger = spdlog::default_logger();
+        logger->debug("build phase histogram of {} pulses", _residue.size());
+        _phase.emplace(_residue, range, bin_width);
+    }
+    return *_phase;
+}
+
+RADAR_ALGORITHM_NS_END
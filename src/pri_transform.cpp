@@ -1,5 +1,4 @@
-#include <vector>
-#include <numbers>
+#include <cmath>
 #include <complex>
 #include <algorithm>
 
@@ -32,39 +31,45 @@ std::optional<double> PRITransform::run(
     if (data.size() < 2) {
         return std::nullopt;
     }
+    return detect(PhaseHistogram(data, range, bin_width));
+}
+
+std::optional<double> PRITransform::run(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width,
+    const SamplingOptions& sampling
+) const noexcept {
+    if (data.size() < 2) {
+        return std::nullopt;
+    }
+    return detect(PhaseHistogram(data, range, bin_width, sampling));
+}
+
+std::optional<double> PRITransform::detect(const PhaseHistogram& hist) const noexcept {
+    if (hist.pulse_num() < 2) {
+        return std::nullopt;
+    }
 
     auto logger = spdlog::default_logger();
-    auto start_toa = data[0];
-    auto end_toa = data.back();
-    auto duration = end_toa - start_toa;
+    auto pulse_num = hist.pulse_num();
+    auto duration = hist.duration();
+    auto range = hist.range();
+    auto bin_width = hist.bin_width();
+    auto bins = hist.bins();
+    // estimated bin is accepted only if its lower confidence bound exceeds
+    // threshold, exact bin has no margin
+    auto margins = hist.margins();
     // threshold to supress subharmonic
-    auto supress_sub = _beta * data.size();
+    auto supress_sub = _beta * pulse_num;
     logger->debug("threshold to supress subharmonic is {}", supress_sub);
     // threshold to supress noise
     auto supress_noise = _gamma * std::sqrt(
-        duration*std::pow(data.size()/duration, 2)*bin_width
+        duration*std::pow(pulse_num/duration, 2)*bin_width
     );
     logger->debug("threshold to supress noise is {}", supress_noise);
-    auto bin_num = (size_t)std::ceil((range.second-range.first)/bin_width)+1;
-    std::vector<std::complex<double>> hist(bin_num);
-
-    for (size_t head = 0; head < data.size()-1; head++) {
-        for (size_t tail = head+1; tail < data.size(); tail++) {
-            auto dtoa = data[tail] - data[head];
-            if (dtoa < range.first) {
-                continue;
-            }
-            if (dtoa > range.second) {
-                break;
-            }
-            constexpr auto two_pi = std::numbers::pi * 2;
-            auto idx = (size_t)std::floor((dtoa-range.first)/bin_width);
-            auto theta = two_pi*(data[tail]/std::max(dtoa, 1e-9));
-            hist[idx] += std::complex<double>(std::cos(theta), std::sin(theta));
-        }
-    }
 
-    for (size_t i = 0; i < bin_num; i++) {
+    for (size_t i = 0; i < bins.size(); i++) {
         auto pri = (i+0.5)*bin_width + range.first;
         auto thr = std::max({
             _alpha*duration/pri,
@@ -75,10 +80,11 @@ std::optional<double> PRITransform::run(
             "for pri {}: threshold is {}, stat value is ({}, {}j)",
             pri,
             thr,
-            hist[i].real(),
-            hist[i].imag()
+            bins[i].real(),
+            bins[i].imag()
         );
-        if (std::abs(hist[i]) > thr) {
+        auto value = std::abs(bins[i]) - (margins.empty() ? 0 : margins[i]);
+        if (value > thr) {
             return std::make_optional(pri);
         }
     }
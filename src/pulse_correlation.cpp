@@ -3,18 +3,34 @@
 #include <cstdint>
 #include <algorithm>
 
+#include <spdlog/spdlog.h>
+
+#include "pair_enumeration.hpp"
 #include "radar_algorithm/pulse_correlation.hpp"
 
 
 RADAR_ALGORITHM_NS_BEGIN()
 
-struct PulsePair {
-    size_t head, tail;
-};
-using StatBin = std::vector<PulsePair>;
+using detail::PulsePair;
+using StatBin = detail::PairBin;
 using Hist = std::vector<StatBin>;
 
 
+/// number of bins could be filled, bin index is relative to `range.first`,
+/// so only bins in range are needed rather than whole duration
+static size_t hist_bin_num(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width
+) noexcept {
+    auto duration = data.back() - data[0];
+    return std::min(
+        (size_t)std::ceil(duration/bin_width),
+        (size_t)std::ceil((range.second-range.first)/bin_width)+1
+    );
+}
+
+
 static Hist calculate_hist(
     std::span<double> data,
     const std::vector<uint32_t>& set,
@@ -22,35 +38,122 @@ static Hist calculate_hist(
     double bin_width,
     size_t merge_num
 ) noexcept {
-    auto start_toa = data[0];
-    auto end_toa = data.back();
-    auto duration = end_toa - start_toa;
-    auto bin_num = (size_t)std::ceil(duration/bin_width);
-    Hist hist(bin_num);
+    Hist hist(hist_bin_num(data, range, bin_width));
 
-    for (size_t head = 0; head < data.size()-1; head++) {
-        if (set[head]) {
-            continue;
-        }
+    detail::PairListAccumulator acc { hist, range.first, bin_width, merge_num };
+    detail::enumerate_range_pairs(
+        data,
+        range,
+        acc,
+        [&set](size_t idx) noexcept { return set[idx] != 0; }
+    );
+    return hist;
+}
 
-        for (size_t tail = head+1; tail < data.size(); tail++) {
-            if (set[tail]) {
-                continue;
-            }
 
-            auto dtoa = data[tail] - data[head];
-            if (dtoa < range.first) {
-                continue;
-            }
-            if (dtoa > range.second) {
-                break;
+/// @brief estimate pair count of bins from sampled heads, and build pair
+///     list only for candidate bins of largest estimated count
+/// @return: histogram laid out as `calculate_hist`, only candidate bins are
+///     filled
+static Hist calculate_sampled_hist(
+    std::span<double> data,
+    const std::vector<uint32_t>& set,
+    std::pair<double, double> range,
+    double bin_width,
+    size_t merge_num,
+    const SamplingOptions& sampling,
+    size_t min_chain
+) noexcept {
+    auto logger = spdlog::default_logger();
+    auto bin_num = hist_bin_num(data, range, bin_width);
+    auto skip = [&set](size_t idx) noexcept { return set[idx] != 0; };
+    // pair index in histogram, same as `PairListAccumulator`
+    auto bin_of = [&](double dtoa) noexcept {
+        return (size_t)std::floor((dtoa-range.first)/bin_width);
+    };
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i+1 < data.size(); i++) {
+        if (!skip(i)) {
+            candidates.push_back(i);
+        }
+    }
+    auto heads = detail::sample_heads(
+        candidates,
+        sampling.ratio,
+        sampling.stratified,
+        sampling.seed
+    );
+    logger->debug("sample {} of {} heads", heads.size(), candidates.size());
+
+    std::vector<double> counts(bin_num, 0);
+    std::vector<double> square(bin_num, 0);
+    detail::SampledAccumulator acc(
+        std::span<double>(counts),
+        std::span<double>(square),
+        [&](const detail::ToaPair& pair, auto&& add) noexcept {
+            auto idx = bin_of(pair.dtoa);
+            if (idx >= bin_num) [[unlikely]] {
+                return;
             }
-            auto idx = (size_t)std::floor((dtoa-range.first)/bin_width);
             size_t max_offset = std::min(idx, merge_num);
             for (size_t offset = 0; offset < max_offset; offset++) {
-                hist[idx-offset].emplace_back(head, tail);
+                add(idx-offset, 1.);
             }
         }
+    );
+    detail::enumerate_head_pairs(data, heads, range, acc, skip);
+    acc.finish_head();
+    auto margins = detail::scale_estimation(
+        std::span(counts),
+        std::span<const double>(square),
+        heads.size(),
+        candidates.size(),
+        sampling.z
+    );
+
+    // bin could not reach `min_chain` even at upper confidence bound
+    // is never searched, bin 0 never receives pairs as in `PairListAccumulator`
+    std::vector<size_t> order;
+    for (size_t i = 1; i < bin_num; i++) {
+        if (counts[i]+margins[i] >= min_chain) {
+            order.push_back(i);
+        }
+    }
+    // ties broken by index, so that full sampling picks bins deterministically
+    auto refine_num = std::min(sampling.refine, order.size());
+    std::partial_sort(
+        order.begin(),
+        order.begin()+refine_num,
+        order.end(),
+        [&counts](size_t i, size_t j) noexcept {
+            return counts[i] > counts[j] or (counts[i] == counts[j] and i < j);
+        }
+    );
+
+    Hist hist(bin_num);
+    for (size_t k = 0; k < refine_num; k++) {
+        auto bin = order[k];
+        auto& pairs = hist[bin];
+        // same bins as `PairListAccumulator` credits pair to
+        auto collect = [&](std::span<const detail::ToaPair> block) noexcept {
+            for (auto& pair : block) {
+                auto idx = bin_of(pair.dtoa);
+                if (idx < bin_num and bin <= idx and idx-bin < merge_num) {
+                    pairs.emplace_back(pair.head, pair.tail);
+                }
+            }
+        };
+        // widen by one bin so pairs on bin edge are decided as above
+        detail::enumerate_range_pairs(
+            data,
+            {
+                std::max(range.first, range.first+(bin-1.)*bin_width),
+                std::min(range.second, range.first+(bin+merge_num+1.)*bin_width)
+            },
+            collect,
+            skip
+        );
     }
     return hist;
 }
@@ -91,7 +194,7 @@ static size_t search_chains(
         }
         if (cache.size() > min_chain) {
             for (auto idx : cache) {
-                set[idx] = 1 << label;
+                set[idx] = 1u << label;
             }
             size += cache.size();
         }
@@ -114,20 +217,60 @@ struct BinSizeCompare {
         return vec1.size() < vec2.size();
     }
 };
-std::optional<std::pair<std::vector<size_t>, std::vector<size_t>>>
-PulseCorrelation::run(
+template<typename Label>
+size_t PulseCorrelation::_run(
     std::span<double> data,
     std::pair<double, double> range,
     double bin_width,
-    size_t merge_num
+    size_t merge_num,
+    const std::optional<SamplingOptions>& sampling,
+    std::span<Label> labels,
+    Label label
 ) const noexcept {
+    auto logger = spdlog::default_logger();
+    if (labels.size() != data.size()) [[unlikely]] {
+        logger->error(
+            "size of labels({}) not equal to size of data({})",
+            labels.size(),
+            data.size()
+        );
+        return 0;
+    }
+    if (label == 0) [[unlikely]] {
+        logger->error("`label` should be non-zero");
+        return 0;
+    }
+    if (sampling and (sampling->ratio <= 0 or sampling->ratio > 1)) {
+        logger->warn("`ratio` should between (0, 1], but got {}", sampling->ratio);
+    }
+    if (sampling and sampling->refine == 0) {
+        logger->warn("`refine` should be positive, no bin will be searched");
+    }
     // early return if data size less than threshold
-    if (data.size() < _thr) {
-        return std::nullopt;
+    if (data.size() < 2 or data.size() < _thr) {
+        return 0;
     }
 
-    std::vector<uint32_t> pulse_set(data.size(), 0);
-    Hist hist = calculate_hist(data, pulse_set, range, bin_width, merge_num);
+    // pulse already labeled by caller is marked with all bits set,
+    // so that it will be skipped as if extracted
+    std::vector<uint32_t> pulse_set(data.size());
+    auto reset_set = [&]() noexcept {
+        for (size_t i = 0; i < data.size(); i++) {
+            pulse_set[i] = labels[i] ? ~uint32_t(0) : 0;
+        }
+    };
+    reset_set();
+    Hist hist = sampling
+        ? calculate_sampled_hist(
+            data,
+            pulse_set,
+            range,
+            bin_width,
+            merge_num,
+            *sampling,
+            _min_chain
+        )
+        : calculate_hist(data, pulse_set, range, bin_width, merge_num);
     // use heap to iter biggest bin
     std::make_heap(hist.begin(), hist.end(), BinSizeCompare());
     uint8_t unique_label = 0;
@@ -139,32 +282,72 @@ PulseCorrelation::run(
         }
         auto size = search_chains(unique_label, bin, pulse_set, _min_chain);
         if (size > _thr) {
-            std::vector<size_t> extracted;
-            std::vector<size_t> remained;
-            extracted.reserve(size);
-            remained.reserve(data.size()-size);
+            size_t count = 0;
             for (size_t i = 0; i < data.size(); i++) {
-                if (pulse_set[i] & (1 << unique_label)) {
-                    extracted.push_back(i);
-                } else {
-                    remained.push_back(i);
+                if (!labels[i] and (pulse_set[i] & (1u << unique_label))) {
+                    labels[i] = label;
+                    count++;
                 }
             }
-            return std::make_optional(
-                std::make_pair(std::move(extracted), std::move(remained))
-            );
+            return count;
         }
 
         unique_label++;
         if (unique_label == 32) [[unlikely]] {
             unique_label = 0;
-            std::fill(pulse_set.begin(), pulse_set.end(), 0);
+            reset_set();
         }
 
         std::pop_heap(hist.begin(), hist.end()-iter_bin_count, BinSizeCompare());
         iter_bin_count++;
     }
-    return std::nullopt;
+    return 0;
+}
+
+size_t PulseCorrelation::run(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width,
+    size_t merge_num,
+    std::span<uint8_t> labels,
+    uint8_t label
+) const noexcept {
+    return _run(data, range, bin_width, merge_num, std::nullopt, labels, label);
+}
+
+size_t PulseCorrelation::run(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width,
+    size_t merge_num,
+    std::span<uint32_t> labels,
+    uint32_t label
+) const noexcept {
+    return _run(data, range, bin_width, merge_num, std::nullopt, labels, label);
+}
+
+size_t PulseCorrelation::run(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width,
+    size_t merge_num,
+    const SamplingOptions& sampling,
+    std::span<uint8_t> labels,
+    uint8_t label
+) const noexcept {
+    return _run(data, range, bin_width, merge_num, sampling, labels, label);
+}
+
+size_t PulseCorrelation::run(
+    std::span<double> data,
+    std::pair<double, double> range,
+    double bin_width,
+    size_t merge_num,
+    const SamplingOptions& sampling,
+    std::span<uint32_t> labels,
+    uint32_t label
+) const noexcept {
+    return _run(data, range, bin_width, merge_num, sampling, labels, label);
 }
 
 RADAR_ALGORITHM_NS_END
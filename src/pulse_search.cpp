@@ -1,5 +1,7 @@
 #include <cmath>
 #include <vector>
+#include <optional>
+#include <algorithm>
 
 #include <spdlog/spdlog.h>
 
@@ -22,23 +24,41 @@ PulseSearcher::PulseSearcher(size_t thr, double toler, double allow_miss_rate) n
     }
 }
 
-std::optional<
-    std::pair<std::vector<size_t>, std::vector<size_t>>
-> PulseSearcher::run(double pri, std::span<double> data) const noexcept {
+template<typename Label>
+size_t PulseSearcher::_run(
+    double pri,
+    std::span<double> data,
+    std::span<Label> labels,
+    Label label
+) const noexcept {
+    auto logger = spdlog::default_logger();
+    if (labels.size() != data.size()) [[unlikely]] {
+        logger->error(
+            "size of labels({}) not equal to size of data({})",
+            labels.size(),
+            data.size()
+        );
+        return 0;
+    }
+    if (label == 0) [[unlikely]] {
+        logger->error("`label` should be non-zero");
+        return 0;
+    }
+
+    // only pulse not extracted yet could be searched
+    size_t free_count = std::count(labels.begin(), labels.end(), Label(0));
     // early return if data size less than threshold
-    if (data.size() < _thr) {
-        return std::nullopt;
+    if (data.empty() or free_count < _thr) {
+        return 0;
     }
 
-    auto logger = spdlog::default_logger();
     std::vector<size_t> cache;
-    std::vector<bool> pulse_set(data.size(), false);
     auto end_toa = data.back();
     size_t pulse_count = 0;
 
     for (size_t start_idx = 0; start_idx < data.size(); start_idx++) {
         // pulse already extracted
-        if (pulse_set[start_idx]) {
+        if (labels[start_idx]) {
             continue;
         }
 
@@ -51,7 +71,7 @@ std::optional<
         // pulse could be extracte less than threshold
         // or remain pulse less than threshold
         // early break
-        if (max_num < _thr or data.size()-pulse_count < _thr) {
+        if (max_num < _thr or free_count-pulse_count < _thr) {
             break;
         }
 
@@ -60,7 +80,7 @@ std::optional<
         size_t idx = start_idx + 1;
         while (idx < data.size() and target < end_toa+_toler) {
             // pulse already extracted
-            if (pulse_set[idx]) {
+            if (labels[idx]) {
                 idx++;
                 continue;
             }
@@ -98,31 +118,127 @@ std::optional<
         // only extract pulse when pulse number exceed threshold
         if (cache.size() >= _thr) {
             for (auto idx : cache) {
-                pulse_set[idx] = true;
+                labels[idx] = label;
             }
             pulse_count += cache.size();
         }
         cache.clear();
     }
+    return pulse_count;
+}
+
+size_t PulseSearcher::run(
+    double pri,
+    std::span<double> data,
+    std::span<uint8_t> labels,
+    uint8_t label
+) const noexcept {
+    return _run(pri, data, labels, label);
+}
+
+size_t PulseSearcher::run(
+    double pri,
+    std::span<double> data,
+    std::span<uint32_t> labels,
+    uint32_t label
+) const noexcept {
+    return _run(pri, data, labels, label);
+}
+
+template<typename Label>
+size_t PulseSearcher::_predict(
+    double pri,
+    double phase,
+    std::span<double> data,
+    std::span<Label> labels,
+    Label label
+) const noexcept {
+    auto logger = spdlog::default_logger();
+    if (labels.size() != data.size()) [[unlikely]] {
+        logger->error(
+            "size of labels({}) not equal to size of data({})",
+            labels.size(),
+            data.size()
+        );
+        return 0;
+    }
+    if (label == 0) [[unlikely]] {
+        logger->error("`label` should be non-zero");
+        return 0;
+    }
+    if (data.empty() or pri <= 0) {
+        return 0;
+    }
 
-    if (pulse_count == 0) {
-        return std::nullopt;
+    auto end_toa = data.back();
+    // first predicted toa could be matched by data
+    auto target = phase + std::ceil((data[0]-_toler-phase)/pri)*pri;
+    auto max_num = (end_toa - target) / pri + 1;
+    auto allow_miss_num = (size_t)std::round(max_num * _allow_miss_rate);
+    if (max_num < _thr) {
+        return 0;
     }
 
-    std::vector<size_t> extracted;
-    std::vector<size_t> remained;
-    extracted.reserve(pulse_count);
-    remained.reserve(data.size()-pulse_count);
-    for (size_t i = 0; i < data.size(); i++) {
-        if (pulse_set[i]) {
-            extracted.push_back(i);
-        } else {
-            remained.push_back(i);
+    std::vector<size_t> cache;
+    size_t miss_num = 0;
+    size_t idx = 0;
+    while (target < end_toa+_toler) {
+        while (idx < data.size() and data[idx] < target-_toler) {
+            idx++;
         }
+        // pulse closest to target in range
+        std::optional<size_t> founded = std::nullopt;
+        for (auto i = idx; i < data.size() and data[i] <= target+_toler; i++) {
+            if (labels[i]) {
+                continue;
+            }
+            if (!founded or std::abs(data[i]-target) < std::abs(data[*founded]-target)) {
+                founded = i;
+            }
+        }
+
+        if (founded) {
+            cache.push_back(*founded);
+            target = data[*founded] + pri;
+            idx = *founded + 1;
+            continue;
+        }
+        target += pri;
+        miss_num++;
+        // emitter disappeared, stop searching
+        if (miss_num > allow_miss_num) {
+            break;
+        }
+    }
+
+    // only extract pulse when pulse number exceed threshold
+    if (cache.size() < _thr) {
+        return 0;
+    }
+    for (auto idx : cache) {
+        labels[idx] = label;
     }
-    return std::make_optional(
-        std::make_pair(std::move(extracted), std::move(remained))
-    );
+    return cache.size();
+}
+
+size_t PulseSearcher::predict(
+    double pri,
+    double phase,
+    std::span<double> data,
+    std::span<uint8_t> labels,
+    uint8_t label
+) const noexcept {
+    return _predict(pri, phase, data, labels, label);
+}
+
+size_t PulseSearcher::predict(
+    double pri,
+    double phase,
+    std::span<double> data,
+    std::span<uint32_t> labels,
+    uint32_t label
+) const noexcept {
+    return _predict(pri, phase, data, labels, label);
 }
 
 RADAR_ALGORITHM_NS_END
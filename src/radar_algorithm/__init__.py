@@ -1 +1 @@
-from .radar_algorithm import PulseSearcher, CDIF, SDIF, PRITransform, PulseCorrelation, LogLevel, set_log_level
+from .radar_algorithm import SamplingOptions, DifferenceHistogram, PhaseHistogram, PulseSearcher, CDIF, SDIF, PRITransform, PulseCorrelation, SweepRecord, ParameterSweeper, Emitter, EmitterChain, Track, ShardedProcessor, KnownEmitter, TrackLibrary, SDIFStage, CDIFStage, PRITransformStage, PulseSearcherStage, PulseCorrelationStage, Pipeline, LogLevel, set_log_level
@@ -1,6 +1,3 @@
-#include <vector>
-#include <cmath>
-
 #include <spdlog/spdlog.h>
 
 #include "radar_algorithm_ns.hpp"
@@ -25,44 +22,46 @@ SDIF::SDIF(double x, double k) noexcept:
 std::optional<double> SDIF::run(
     std::span<double> data,
     int max_rank,
-    double bin_width
+    double bin_width,
+    std::optional<std::pair<double, double>> range
 ) const noexcept {
     if (data.size() < 2) {
         return std::nullopt;
     }
-
-    auto logger = spdlog::default_logger();
-    auto start_toa = data[0];
-    auto end_toa = data.back();
-    auto duration = end_toa - start_toa;
-    auto bin_num = (size_t)std::ceil(duration / bin_width);
-
+    // build rank by rank, so that higher ranks are never enumerated once
+    // pri detected
+    DifferenceHistogram hist(data, 0, bin_width, range);
+    RankState state;
     for (int rank = 1; rank <= max_rank; rank++) {
-        logger->debug("rank {}", rank);
-        std::vector<size_t> hist(bin_num, 0);
-        for (size_t i = 0; i < data.size()-rank; i++) {
-            auto dtoa = data[i+rank] - data[i];
-            auto idx = (size_t)std::floor(dtoa / bin_width);
-            hist[idx]++;
-        }
-
-        std::vector<double> pris;
-        for (size_t i = 0; i < bin_num; i++) {
-            auto pri = (i+0.5)*bin_width;
-            auto thr = _x*(data.size()-rank)*std::exp(-pri/_k/bin_num);
-            logger->debug("for pri {}: threshold is {}, stat value is {}", pri, thr, hist[i]);
-            if (hist[i] > thr) {
-                pris.push_back(pri);
-            }
+        hist.add_rank(data);
+        if (auto pri = detect_rank(hist, rank, state)) {
+            return pri;
         }
+    }
+    return std::nullopt;
+}
 
-        if (pris.empty() or (rank == 1 and pris.size() > 1)) {
-            continue;
+std::optional<double> SDIF::detect(const DifferenceHistogram& hist) const noexcept {
+    if (hist.pulse_num() < 2) {
+        return std::nullopt;
+    }
+    RankState state;
+    for (int rank = 1; rank <= hist.max_rank(); rank++) {
+        if (auto pri = detect_rank(hist, rank, state)) {
+            return pri;
         }
-
-        return std::make_optional(pris[0]);
     }
     return std::nullopt;
 }
 
+std::optional<double> SDIF::detect_rank(
+    const DifferenceHistogram& hist,
+    int rank,
+    RankState& state
+) const noexcept {
+    auto logger = spdlog::default_logger();
+    logger->debug("rank {}", rank);
+    return _detect_rank(hist, rank, state);
+}
+
 RADAR_ALGORITHM_NS_END
@@ -0,0 +1,218 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "radar_algorithm/shard.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+/// emitters and local labels of one window
+struct WindowResult {
+    /// index of first pulse of window in whole data
+    size_t begin;
+    std::vector<uint32_t> labels;
+    std::vector<Emitter> emitters;
+};
+
+
+ShardedProcessor::ShardedProcessor(
+    ThreadPool& pool,
+    EmitterExtractor chain,
+    double window,
+    double overlap,
+    double pri_toler,
+    double phase_toler,
+    size_t max_gap
+) noexcept:
+    _pool(pool),
+    _chain(std::move(chain)),
+    _window(window),
+    _overlap(overlap),
+    _pri_toler(pri_toler),
+    _phase_toler(phase_toler),
+    _max_gap(max_gap)
+{
+    auto logger = spdlog::default_logger();
+    if (_window <= 0) {
+        logger->warn("`window` must be positive number, but got {}", _window);
+    }
+    if (_overlap < 0 or _overlap >= _window) {
+        logger->warn("`overlap` should between [0, {}), but got {}", _window, _overlap);
+    }
+}
+
+std::vector<Track> ShardedProcessor::run(
+    std::span<double> data,
+    std::span<uint32_t> labels
+) const {
+    auto logger = spdlog::default_logger();
+    if (labels.size() != data.size()) [[unlikely]] {
+        logger->error(
+            "size of labels({}) not equal to size of data({})",
+            labels.size(),
+            data.size()
+        );
+        return {};
+    }
+    auto step = _window - _overlap;
+    if (_window <= 0 or step <= 0) [[unlikely]] {
+        logger->error("invalid window {} with overlap {}", _window, _overlap);
+        return {};
+    }
+    std::fill(labels.begin(), labels.end(), 0);
+    if (data.empty()) {
+        return {};
+    }
+
+    // split data into windows
+    std::vector<WindowResult> windows;
+    for (size_t k = 0; ; k++) {
+        auto start = data[0] + k*step;
+        auto begin = std::lower_bound(data.begin(), data.end(), start);
+        auto end = std::lower_bound(begin, data.end(), start+_window);
+        windows.emplace_back((size_t)(begin-data.begin()));
+        windows.back().labels.resize(end-begin, 0);
+        if (end == data.end()) {
+            break;
+        }
+    }
+    logger->debug("split data into {} windows", windows.size());
+
+    _pool.parallel_for(windows.size(), [&](size_t i) {
+        auto& window = windows[i];
+        window.emitters = _chain(
+            data.subspan(window.begin, window.labels.size()),
+            window.labels,
+            1
+        );
+    });
+
+    // stitch emitters into tracks window by window
+    std::vector<Track> tracks;
+    // pulse number of emitters merged into each track, weight to average pri
+    std::vector<size_t> weights;
+    // index of window each track last updated by
+    std::vector<size_t> last_window;
+    for (size_t w = 0; w < windows.size(); w++) {
+        auto& window = windows[w];
+        // tracks missed by at most `max_gap` windows could be continued,
+        // their phase is still predicted from last toa and pri
+        std::vector<size_t> active;
+        for (size_t idx = 0; idx < tracks.size(); idx++) {
+            if (w-last_window[idx] <= _max_gap+1) {
+                active.push_back(idx);
+            }
+        }
+        std::vector<bool> used(active.size(), false);
+        // track index of each local label
+        std::vector<size_t> track_of(window.emitters.size()+1);
+        // pulses in overlap already labeled by previous window vote for
+        // which track each emitter continues
+        std::vector<std::vector<size_t>> votes(
+            window.emitters.size()+1,
+            std::vector<size_t>(active.size(), 0)
+        );
+        for (size_t i = 0; i < window.labels.size(); i++) {
+            auto local = window.labels[i];
+            auto label = labels[window.begin+i];
+            if (!local or !label) {
+                continue;
+            }
+            for (size_t j = 0; j < active.size(); j++) {
+                if (tracks[active[j]].label == label) {
+                    votes[local][j]++;
+                    break;
+                }
+            }
+        }
+
+        for (auto& emitter : window.emitters) {
+            size_t best = active.size();
+            size_t best_votes = 0;
+            double best_residual = std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < active.size(); i++) {
+                auto& track = tracks[active[i]];
+                if (used[i] or std::abs(emitter.pri-track.pri) > _pri_toler*track.pri) {
+                    continue;
+                }
+                // prefer track sharing most pulses, then track whose phase
+                // fits best, first pulse of emitter should be integral pri
+                // after last pulse of track
+                auto dtoa = emitter.first_toa - track.last_toa;
+                auto residual = std::abs(dtoa - std::round(dtoa/track.pri)*track.pri);
+                auto vote = votes[emitter.label][i];
+                if (vote == 0 and residual > _phase_toler) {
+                    continue;
+                }
+                if (
+                    vote > best_votes
+                    or (vote == best_votes and residual < best_residual)
+                ) {
+                    best = i;
+                    best_votes = vote;
+                    best_residual = residual;
+                }
+            }
+
+            size_t idx;
+            if (best < active.size()) {
+                used[best] = true;
+                idx = active[best];
+                auto& track = tracks[idx];
+                track.pri = (track.pri*weights[idx] + emitter.pri*emitter.pulse_num)
+                    / (weights[idx]+emitter.pulse_num);
+                track.first_toa = std::min(track.first_toa, emitter.first_toa);
+                track.last_toa = std::max(track.last_toa, emitter.last_toa);
+                weights[idx] += emitter.pulse_num;
+            } else {
+                idx = tracks.size();
+                tracks.emplace_back(
+                    (uint32_t)idx+1,
+                    emitter.pri,
+                    emitter.first_toa,
+                    emitter.last_toa,
+                    0
+                );
+                weights.push_back(emitter.pulse_num);
+                last_window.push_back(w);
+            }
+            track_of[emitter.label] = idx;
+            last_window[idx] = w;
+        }
+
+        // pulse in overlap keeps track assigned by previous window
+        for (size_t i = 0; i < window.labels.size(); i++) {
+            auto local = window.labels[i];
+            auto& label = labels[window.begin+i];
+            if (local and !label) {
+                auto& track = tracks[track_of[local]];
+                label = track.label;
+                track.pulse_num++;
+            }
+        }
+    }
+
+    // drop tracks whose pulses all taken by previous window
+    std::vector<uint32_t> relabel(tracks.size()+1, 0);
+    size_t kept = 0;
+    for (auto& track : tracks) {
+        if (track.pulse_num) {
+            relabel[track.label] = kept+1;
+            tracks[kept] = track;
+            tracks[kept].label = kept+1;
+            kept++;
+        }
+    }
+    if (kept != tracks.size()) {
+        tracks.resize(kept);
+        for (auto& label : labels) {
+            label = relabel[label];
+        }
+    }
+    return tracks;
+}
+
+RADAR_ALGORITHM_NS_END
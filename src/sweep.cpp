@@ -0,0 +1,372 @@
+#include <map>
+#include <set>
+#include <cmath>
+#include <tuple>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "radar_algorithm/cdif.hpp"
+#include "radar_algorithm/sdif.hpp"
+#include "radar_algorithm/sweep.hpp"
+#include "radar_algorithm/histogram.hpp"
+#include "radar_algorithm/pulse_search.hpp"
+#include "radar_algorithm/pri_transform.hpp"
+#include "radar_algorithm/pulse_correlation.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+using Clock = std::chrono::steady_clock;
+using Grid = std::vector<std::vector<double>>;
+/// accuracy and runtime of one combination on one dataset
+using Score = std::pair<double, double>;
+
+
+static double seconds_since(Clock::time_point start) noexcept {
+    return std::chrono::duration<double>(Clock::now()-start).count();
+}
+
+
+/// cartesian product of parameter axes, last axis changes fastest
+static Grid make_grid(std::initializer_list<std::vector<double>> axes) {
+    Grid grid { {} };
+    for (auto& axis : axes) {
+        Grid next;
+        next.reserve(grid.size()*axis.size());
+        for (auto& params : grid) {
+            for (auto value : axis) {
+                next.push_back(params);
+                next.back().push_back(value);
+            }
+        }
+        grid = std::move(next);
+    }
+    return grid;
+}
+
+
+template<typename T>
+static std::vector<double> to_axis(std::span<const T> values) {
+    return std::vector<double>(values.begin(), values.end());
+}
+
+
+static bool check_datasets(std::span<const LabeledDataset> datasets) noexcept {
+    auto logger = spdlog::default_logger();
+    for (size_t i = 0; i < datasets.size(); i++) {
+        auto& dataset = datasets[i];
+        if (dataset.labels.size() != dataset.toas.size()) [[unlikely]] {
+            logger->error(
+                "size of labels({}) not equal to size of toas({}) in dataset {}",
+                dataset.labels.size(),
+                dataset.toas.size(),
+                i
+            );
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/// @brief evaluate every combination on every dataset in parallel
+/// @param eval: callable with params and dataset index, return score
+static std::vector<SweepRecord> evaluate(
+    ThreadPool& pool,
+    Grid grid,
+    size_t dataset_num,
+    auto&& eval
+) {
+    std::vector<Score> scores(grid.size()*dataset_num);
+    pool.parallel_for(scores.size(), [&](size_t i) {
+        scores[i] = eval(grid[i/dataset_num], i%dataset_num);
+    });
+
+    std::vector<SweepRecord> records;
+    records.reserve(grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        double accuracy = 0;
+        double runtime = 0;
+        for (size_t j = 0; j < dataset_num; j++) {
+            accuracy += scores[i*dataset_num+j].first;
+            runtime += scores[i*dataset_num+j].second;
+        }
+        if (dataset_num) {
+            accuracy /= dataset_num;
+            runtime /= dataset_num;
+        }
+        records.emplace_back(std::move(grid[i]), accuracy, runtime);
+    }
+    return records;
+}
+
+
+/// @brief build one histogram of each dataset in parallel
+/// @return: histograms and their build time
+template<typename Hist, typename... Args>
+static std::pair<std::vector<std::unique_ptr<Hist>>, std::vector<double>>
+build_hists(
+    ThreadPool& pool,
+    std::span<const LabeledDataset> datasets,
+    Args... args
+) {
+    std::vector<std::unique_ptr<Hist>> hists(datasets.size());
+    std::vector<double> build_time(datasets.size());
+    pool.parallel_for(datasets.size(), [&](size_t i) {
+        auto start = Clock::now();
+        hists[i] = std::make_unique<Hist>(datasets[i].toas, args...);
+        build_time[i] = seconds_since(start);
+    });
+    return std::make_pair(std::move(hists), std::move(build_time));
+}
+
+
+/// 1 if pri matches one of emitters, and 0 otherwise,
+/// dataset without emitter matches no detection
+static double pri_accuracy(
+    std::optional<double> pri,
+    const LabeledDataset& dataset,
+    double pri_toler
+) noexcept {
+    if (!pri) {
+        return dataset.pris.empty();
+    }
+    for (auto truth : dataset.pris) {
+        if (std::abs(*pri-truth) <= pri_toler*truth) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/// @brief rate of correctly labeled pulse, extracted labels and emitters are
+///     matched one to one greedily by shared pulses, so pulses of extra
+///     fragments of emitter are errors, unextracted pulse is correct only if
+///     it is noise
+static double labeling_accuracy(
+    std::span<const uint32_t> truth,
+    std::span<const uint32_t> predicted
+) noexcept {
+    if (truth.empty()) {
+        return 1;
+    }
+
+    // pulse count of each (predicted, truth) label pair
+    std::map<std::pair<uint32_t, uint32_t>, size_t> counts;
+    for (size_t i = 0; i < truth.size(); i++) {
+        counts[{ predicted[i], truth[i] }]++;
+    }
+    size_t correct = 0;
+    // (count, predicted, truth) of pairs could be matched
+    std::vector<std::tuple<size_t, uint32_t, uint32_t>> pairs;
+    for (auto& [key, count] : counts) {
+        auto [predicted_label, truth_label] = key;
+        if (predicted_label == 0) {
+            correct += truth_label == 0 ? count : 0;
+        } else if (truth_label != 0) {
+            pairs.emplace_back(count, predicted_label, truth_label);
+        }
+    }
+    // match pairs sharing most pulses first, ties broken by labels
+    std::sort(
+        pairs.begin(),
+        pairs.end(),
+        [](const auto& a, const auto& b) {
+            auto& [count_a, predicted_a, truth_a] = a;
+            auto& [count_b, predicted_b, truth_b] = b;
+            if (count_a != count_b) {
+                return count_a > count_b;
+            }
+            return std::make_pair(predicted_a, truth_a) < std::make_pair(predicted_b, truth_b);
+        }
+    );
+    std::set<uint32_t> matched_predicted, matched_truth;
+    for (auto [count, predicted_label, truth_label] : pairs) {
+        if (
+            matched_predicted.contains(predicted_label)
+            or matched_truth.contains(truth_label)
+        ) {
+            continue;
+        }
+        matched_predicted.insert(predicted_label);
+        matched_truth.insert(truth_label);
+        correct += count;
+    }
+    return (double)correct / truth.size();
+}
+
+
+ParameterSweeper::ParameterSweeper(ThreadPool& pool, double pri_toler) noexcept:
+    _pool(pool),
+    _pri_toler(pri_toler)
+{
+    auto logger = spdlog::default_logger();
+    if (_pri_toler < 0) {
+        logger->warn("`pri_toler` must be positive number, but got {}", _pri_toler);
+    }
+}
+
+std::vector<SweepRecord> ParameterSweeper::sweep_sdif(
+    std::span<const LabeledDataset> datasets,
+    std::span<const double> xs,
+    std::span<const double> ks,
+    int max_rank,
+    double bin_width
+) const {
+    if (!check_datasets(datasets)) {
+        return {};
+    }
+
+    auto [hists, build_time] = build_hists<DifferenceHistogram>(
+        _pool,
+        datasets,
+        max_rank,
+        bin_width
+    );
+    return evaluate(
+        _pool,
+        make_grid({ to_axis(xs), to_axis(ks) }),
+        datasets.size(),
+        [&](const std::vector<double>& params, size_t i) {
+            auto start = Clock::now();
+            auto pri = SDIF(params[0], params[1]).detect(*hists[i]);
+            auto runtime = build_time[i] + seconds_since(start);
+            return Score(pri_accuracy(pri, datasets[i], _pri_toler), runtime);
+        }
+    );
+}
+
+std::vector<SweepRecord> ParameterSweeper::sweep_cdif(
+    std::span<const LabeledDataset> datasets,
+    std::span<const double> ks,
+    int max_rank,
+    double bin_width
+) const {
+    if (!check_datasets(datasets)) {
+        return {};
+    }
+
+    auto [hists, build_time] = build_hists<DifferenceHistogram>(
+        _pool,
+        datasets,
+        max_rank,
+        bin_width
+    );
+    return evaluate(
+        _pool,
+        make_grid({ to_axis(ks) }),
+        datasets.size(),
+        [&](const std::vector<double>& params, size_t i) {
+            auto start = Clock::now();
+            auto pri = CDIF(params[0]).detect(*hists[i]);
+            auto runtime = build_time[i] + seconds_since(start);
+            return Score(pri_accuracy(pri, datasets[i], _pri_toler), runtime);
+        }
+    );
+}
+
+std::vector<SweepRecord> ParameterSweeper::sweep_pri_transform(
+    std::span<const LabeledDataset> datasets,
+    std::span<const double> alphas,
+    std::span<const double> betas,
+    std::span<const double> gammas,
+    std::pair<double, double> range,
+    double bin_width
+) const {
+    if (!check_datasets(datasets)) {
+        return {};
+    }
+
+    auto [hists, build_time] = build_hists<PhaseHistogram>(
+        _pool,
+        datasets,
+        range,
+        bin_width
+    );
+    return evaluate(
+        _pool,
+        make_grid({ to_axis(alphas), to_axis(betas), to_axis(gammas) }),
+        datasets.size(),
+        [&](const std::vector<double>& params, size_t i) {
+            auto start = Clock::now();
+            auto pri = PRITransform(params[0], params[1], params[2]).detect(*hists[i]);
+            auto runtime = build_time[i] + seconds_since(start);
+            return Score(pri_accuracy(pri, datasets[i], _pri_toler), runtime);
+        }
+    );
+}
+
+std::vector<SweepRecord> ParameterSweeper::sweep_pulse_searcher(
+    std::span<const LabeledDataset> datasets,
+    std::span<const size_t> thrs,
+    std::span<const double> tolers,
+    std::span<const double> allow_miss_rates
+) const {
+    if (!check_datasets(datasets)) {
+        return {};
+    }
+
+    return evaluate(
+        _pool,
+        make_grid({ to_axis(thrs), to_axis(tolers), to_axis(allow_miss_rates) }),
+        datasets.size(),
+        [&](const std::vector<double>& params, size_t i) {
+            auto& dataset = datasets[i];
+            std::vector<uint32_t> labels(dataset.toas.size(), 0);
+            auto start = Clock::now();
+            PulseSearcher searcher((size_t)params[0], params[1], params[2]);
+            for (size_t j = 0; j < dataset.pris.size(); j++) {
+                searcher.run(dataset.pris[j], dataset.toas, std::span(labels), (uint32_t)j+1);
+            }
+            auto runtime = seconds_since(start);
+            return Score(labeling_accuracy(dataset.labels, labels), runtime);
+        }
+    );
+}
+
+std::vector<SweepRecord> ParameterSweeper::sweep_pulse_correlation(
+    std::span<const LabeledDataset> datasets,
+    std::span<const size_t> min_chains,
+    std::span<const size_t> thrs,
+    std::pair<double, double> range,
+    double bin_width,
+    size_t merge_num
+) const {
+    if (!check_datasets(datasets)) {
+        return {};
+    }
+
+    return evaluate(
+        _pool,
+        make_grid({ to_axis(min_chains), to_axis(thrs) }),
+        datasets.size(),
+        [&](const std::vector<double>& params, size_t i) {
+            auto& dataset = datasets[i];
+            std::vector<uint32_t> labels(dataset.toas.size(), 0);
+            auto start = Clock::now();
+            PulseCorrelation correlation((size_t)params[0], (size_t)params[1]);
+            // every successful extraction labels at least one more pulse
+            uint32_t label = 1;
+            while (
+                correlation.run(
+                    dataset.toas,
+                    range,
+                    bin_width,
+                    merge_num,
+                    std::span(labels),
+                    label
+                )
+            ) {
+                label++;
+            }
+            auto runtime = seconds_since(start);
+            return Score(labeling_accuracy(dataset.labels, labels), runtime);
+        }
+    );
+}
+
+RADAR_ALGORITHM_NS_END
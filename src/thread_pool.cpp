@@ -0,0 +1,72 @@
+#include <spdlog/spdlog.h>
+
+#include "radar_algorithm/thread_pool.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+ThreadPool::ThreadPool(size_t thread_num) noexcept:
+    _stopped(false)
+{
+    if (thread_num == 0) {
+        thread_num = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    auto logger = spdlog::default_logger();
+    logger->debug("start thread pool with {} threads", thread_num);
+
+    _workers.reserve(thread_num);
+    for (size_t i = 0; i < thread_num; i++) {
+        _workers.emplace_back([this]() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(_mutex);
+                    _cond.wait(lock, [this]() { return _stopped or !_tasks.empty(); });
+                    // drain all tasks before exit
+                    if (_tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(_tasks.front());
+                    _tasks.pop();
+                }
+                task();
+            }
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    shutdown();
+}
+
+size_t ThreadPool::size() const noexcept {
+    return _workers.size();
+}
+
+void ThreadPool::shutdown() noexcept {
+    {
+        std::lock_guard lock(_mutex);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _cond.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::_push(std::function<void()> task) {
+    {
+        std::lock_guard lock(_mutex);
+        if (!_stopped) {
+            _tasks.push(std::move(task));
+            _cond.notify_one();
+            return;
+        }
+    }
+    task();
+}
+
+RADAR_ALGORITHM_NS_END
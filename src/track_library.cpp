@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "radar_algorithm/pulse_search.hpp"
+#include "radar_algorithm/track_library.hpp"
+
+
+RADAR_ALGORITHM_NS_BEGIN()
+
+TrackLibrary::TrackLibrary(
+    EmitterExtractor chain,
+    size_t thr,
+    double toler,
+    double allow_miss_rate,
+    size_t max_age
+) noexcept:
+    _chain(std::move(chain)),
+    _thr(thr),
+    _toler(toler),
+    _allow_miss_rate(allow_miss_rate),
+    _max_age(max_age),
+    _next_id(1)
+{
+    auto logger = spdlog::default_logger();
+    if (_allow_miss_rate > 1 or _allow_miss_rate < 0) {
+        logger->warn("`allow_miss_rate` should between (0, 1), but got {}", _allow_miss_rate);
+    }
+    if (_toler < 0) {
+        logger->warn("`toler` must be positive number, but got {}", _toler);
+    }
+}
+
+std::vector<Emitter> TrackLibrary::process(
+    std::span<double> data,
+    std::span<uint32_t> labels
+) {
+    auto logger = spdlog::default_logger();
+    if (labels.size() != data.size()) [[unlikely]] {
+        logger->error(
+            "size of labels({}) not equal to size of data({})",
+            labels.size(),
+            data.size()
+        );
+        return {};
+    }
+    std::fill(labels.begin(), labels.end(), 0);
+
+    std::lock_guard lock(_mutex);
+    std::vector<Emitter> found;
+    // extract known emitters by prediction at first
+    for (auto& known : _emitters) {
+        PulseSearcher searcher(_thr, known.toler, _allow_miss_rate);
+        auto count = searcher.predict(known.pri, known.phase, data, labels, known.id);
+        if (count == 0) {
+            known.age++;
+            continue;
+        }
+        auto emitter = make_emitter(data, labels, known.id, known.pri);
+        known.pri = emitter.pri;
+        known.phase = emitter.last_toa;
+        known.age = 0;
+        found.push_back(emitter);
+    }
+    logger->debug(
+        "{} pulses of {} known emitters extracted by prediction",
+        std::count_if(labels.begin(), labels.end(), [](auto label) { return label; }),
+        found.size()
+    );
+
+    // discover new emitters from residue
+    auto emitters = _chain(data, labels, _next_id);
+    for (auto& emitter : emitters) {
+        _emitters.emplace_back(emitter.label, emitter.pri, emitter.last_toa, _toler, 0);
+        found.push_back(emitter);
+    }
+    _next_id += emitters.size();
+
+    std::erase_if(_emitters, [this](const KnownEmitter& known) {
+        return known.age > _max_age;
+    });
+    return found;
+}
+
+std::vector<KnownEmitter> TrackLibrary::emitters() const {
+    std::lock_guard lock(_mutex);
+    return _emitters;
+}
+
+void TrackLibrary::clear() noexcept {
+    std::lock_guard lock(_mutex);
+    _emitters.clear();
+}
+
+RADAR_ALGORITHM_NS_END